@@ -1,431 +1,992 @@
 #include "AD5593R.h"
-#include <Wire.h>
+#include "AD5593R_Registers.h"
+#include "AD5593R_Bus.h"
+#include "AD5593R_Monitor.h"
 
-//Definitions
-#define _ADAC_NULL           B00000000
-#define _ADAC_ADC_SEQUENCE   B00000010 // ADC sequence register - Selects ADCs for conversion
-#define _ADAC_GP_CONTROL     B00000011 // General-purpose control register - DAC and ADC control register
-#define _ADAC_ADC_CONFIG     B00000100 // ADC pin configuration - Selects which pins are ADC inputs
-#define _ADAC_DAC_CONFIG     B00000101 // DAC pin configuration - Selects which pins are DAC outputs
-#define _ADAC_PULL_DOWN      B00000110 // Pull-down configuration - Selects which pins have an 85 kO pull-down resistor to GND
-#define _ADAC_LDAC_MODE      B00000111 // LDAC mode - Selects the operation of the load DAC
-#define _ADAC_GPIO_WR_CONFIG B00001000 // GPIO write configuration - Selects which pins are general-purpose outputs
-#define _ADAC_GPIO_WR_DATA   B00001001 // GPIO write data - Writes data to general-purpose outputs
-#define _ADAC_GPIO_RD_CONFIG B00001010 // GPIO read configuration - Selects which pins are general-purpose inputs
-#define _ADAC_POWER_REF_CTRL B00001011 // Power-down/reference control - Powers down the DACs and enables/disables the reference
-#define _ADAC_OPEN_DRAIN_CFG B00001100 // Open-drain configuration - Selects open-drain or push-pull for general-purpose outputs
-#define _ADAC_THREE_STATE    B00001101 // Three-state pins - Selects which pins are three-stated
-#define _ADAC_RESERVED       B00001110 // Reserved
-#define _ADAC_SOFT_RESET     B00001111 // Software reset - Resets the AD5593R
 
-/**
- * @name     ADAC Configuration Data Bytes
- ******************************************************************************/
- ///@{
- //write into MSB after _ADAC_POWER_REF_CTRL command to enable VREF
-#define _ADAC_VREF_ON     B00000010
-#define _ADAC_SEQUENCE_ON B00000010
+//Class constructor
+AD5593R::AD5593R(int a0) : AD5593R(AD5593R_default_transport(), a0) {
+}
+
+#ifdef ARDUINO
+AD5593R::AD5593R(TwoWire& wire, int a0) : AD5593R(AD5593R_wire_transport(wire), a0) {
+}
+#endif
 
+AD5593R::AD5593R(AD5593R_Transport& transport, int a0) {
+
+  _a0 = a0;
+  _transport = &transport;
+  //intializing the configuration struct.
+  for (int i = 0; i < _num_of_channels; i++) {
+    config.ADCs[i] = 0;
+    config.DACs[i] = 0;
+    config.GPIs[i] = 0;
+    config.GPOs[i] = 0;
+  }
 
+  //the shadow starts out at the power-on values, but none of them is trusted until written
+  for (int i = 0; i < 16; i++) {
+    _registers[i] = 0x0000;
+    _pending[i] = 0x0000;
+  }
+  _registers[_ADAC_PULL_DOWN] = 0x00ff;
+  _registers_valid = 0;
+  _registers_dirty = 0;
+
+  _health.online = 1;
+  _health.failures = 0;
+  _health.last_error = AD5593R_OK;
+  _health.errors = 0;
+  _health.retries = 0;
+  _health.recoveries = 0;
+  _health.last_attempt = 0;
+#ifdef AD5593R_STATS
+  _stats.clear();
+#endif
 
-/**
- * @name   ADAC Write / Read Pointer Bytes
-******************************************************************************/
-///@{
-#define _ADAC_DAC_WRITE       B00010000
-#define _ADAC_ADC_READ        B01000000
-#define _ADAC_DAC_READ        B01010000
-#define _ADAC_GPIO_READ       B01110000
-#define _ADAC_REG_READ        B01100000
+  for (int i = 0; i < _num_of_channels; i++) {
+    values.ADCs[i] = -1;
+    values.DACs[i] = -1;
+    values.GPI_reads[i] = 0;
+    values.GPO_writes[i] = 0;
+    values.ADC_codes[i] = 0;
+    values.DAC_codes[i] = 0;
+    _ADC_tables[i] = nullptr;
+    _DAC_tables[i] = nullptr;
+  }
+  values.temperature = 0;
+  values.temperature_code = 0;
 
+  //this allows for multiple devices on the same bus, see header.
+  _transport->attach_a0(_a0);
+  _transport->begin();
+  _publish();
+}
 
+void AD5593R::_select() {
+  //a bus manager keeps the device selected until another device needs the bus
+  if (_bus != nullptr) {
+    _bus->_activate(this);
+    return;
+  }
+  if (_a0_low) return;
+  _transport->set_a0(_a0, LOW);
+  _a0_low = 1;
+}
 
+void AD5593R::_deselect() {
+  if (_bus != nullptr || !_a0_low) return;
+  _transport->set_a0(_a0, HIGH);
+  _a0_low = 0;
+}
 
+AD5593R_Status AD5593R::_write_register(byte pointer, byte msbs, byte lsbs) {
+  byte data[3] = {pointer, msbs, lsbs};
+  return _write_frames(data, 3);
+}
 
+AD5593R_Status AD5593R::_write_frames(const byte* data, size_t length) {
+  _read_pointer = _ADAC_NULL;
+  return AD5593R_burst(length, [this, data](size_t start, size_t chunk) {
+    AD5593R_Status status = _write(data + start, chunk);
+
+    //keep the shadow of the control registers in step with the device
+    for (size_t i = start; i < start + chunk; i += 3) {
+      byte pointer = data[i];
+      if (pointer >= 16) continue;
+      uint16_t register_bit = 1 << pointer;
+      if (status == AD5593R_OK) {
+        _registers[pointer] = (uint16_t(data[i + 1]) << 8) | data[i + 2];
+        //a load returns the LDAC mode to direct by itself
+        if (pointer == _ADAC_LDAC_MODE && (_registers[pointer] & 0x03) == _ADAC_LDAC_LOAD) {
+          _registers[pointer] = _ADAC_LDAC_DIRECT;
+        }
+        _registers_valid |= register_bit;
+        _registers_dirty &= ~register_bit;
+      }
+      else {
+        //_registers keeps the last confirmed value, the next update of the register writes it again
+        _registers_valid &= ~register_bit;
+        _registers_dirty &= ~register_bit;
+      }
+    }
+    return status;
+  });
+}
 
-//Class constructor
-AD5593R::AD5593R(int a0) {
+AD5593R_Status AD5593R::_update_register(byte address, uint16_t value) {
+  uint16_t register_bit = 1 << address;
+  //nothing to do if the device holds, or is about to receive, the same value
+  if (_register(address) == value && ((_registers_valid | _registers_dirty) & register_bit)) return AD5593R_OK;
+  _pending[address] = value;
+  _registers_dirty |= register_bit;
+  if (_update_depth > 0) return AD5593R_OK;
+  return _flush_registers();
+}
+
+AD5593R_Status AD5593R::_flush_registers() {
+  if (_registers_dirty == 0) return AD5593R_OK;
+  byte data[3 * 16];
+  size_t length = 0;
+  for (byte address = 0; address < 16; address++) {
+    if (_registers_dirty & (1 << address)) {
+      data[length++] = address;
+      data[length++] = _pending[address] >> 8;
+      data[length++] = _pending[address] & 0xff;
+    }
+  }
+  return _write_frames(data, length);
+}
+
+void AD5593R::begin_update() {
+  _update_depth++;
+}
+
+AD5593R_Status AD5593R::end_update() {
+  if (_update_depth > 0) _update_depth--;
+  if (_update_depth > 0 || _registers_dirty == 0) return AD5593R_OK;
+  _select();
+  AD5593R_Status status = _flush_registers();
+  _deselect();
+  return status;
+}
+
+uint16_t AD5593R::get_register(byte address) {
+  return _registers[address & 0x0f];
+}
+
+void AD5593R::set_ADC_table(byte channel, const uint16_t* table) {
+  _ADC_tables[channel & 0x07] = table;
+}
+
+void AD5593R::set_DAC_table(byte channel, const uint16_t* table) {
+  _DAC_tables[channel & 0x07] = table;
+}
+
+#ifdef AD5593R_STATS
+void AD5593R::get_stats(AD5593R_Stats* snapshot) {
+  *snapshot = _stats;
+}
+
+void AD5593R::reset_stats() {
+  _stats.clear();
+}
+#endif
+
+AD5593R_Status AD5593R::_write_pointer(byte pointer) {
+  AD5593R_Status status = _write(&pointer, 1);
+  _read_pointer = status == AD5593R_OK ? pointer : _ADAC_NULL;
+  return status;
+}
+
+AD5593R_Status AD5593R::_write(const byte* data, size_t length) {
+  if (!_may_transact()) return AD5593R_ERROR_OFFLINE;
+  byte status = AD5593R_retry_write(*_transport, _i2c_address, data, length, _attempts(), _backoff,
+                                    [this](size_t written, size_t read, bool error, bool retrying) {
+    AD5593R_STATS_TRANSACTION(written, read, error);
+    if (retrying) _health.retries++;
+  });
+  return _completed(AD5593R_write_status(status));
+}
+
+size_t AD5593R::_read(byte* data, size_t length) {
+  if (!_may_transact()) return 0;
+  size_t received = AD5593R_retry_read(*_transport, _i2c_address, data, length, _attempts(), _backoff,
+                                       [this](size_t written, size_t read, bool error, bool retrying) {
+    AD5593R_STATS_TRANSACTION(written, read, error);
+    if (retrying) _health.retries++;
+  });
+  _completed(received == length ? AD5593R_OK : AD5593R_ERROR_SHORT_READ);
+  return received;
+}
+
+bool AD5593R::_may_transact() {
+  if (_health.online) return 1;
+  unsigned long now = millis();
+  if (now - _health.last_attempt < AD5593R_OFFLINE_PROBE_MS) return 0;
+  _health.last_attempt = now;
+  return 1;
+}
+
+AD5593R_Status AD5593R::_completed(AD5593R_Status status) {
+  if (status == AD5593R_OK) {
+    _health.failures = 0;
+    if (!_health.online) {
+      _health.online = 1;
+      AD5593R_LOG_INFO(AD5593R_EVENT_ONLINE, 0xff, 0);
+    }
+    return status;
+  }
+  _health.errors++;
+  _health.last_error = status;
+  if (_health.failures < 255) _health.failures++;
+  AD5593R_LOG_ERROR(AD5593R_EVENT_BUS_ERROR, 0xff, uint16_t(-status));
+  //a device that does not answer leaves the bus idle, and a recovery would disturb the other devices
+  //sharing it, so only a bus error or SDA held low calls for one
+  if (status == AD5593R_ERROR_BUS || _transport->stuck()) {
+    _transport->recover();
+    _health.recoveries++;
+  }
+  if (_health.online && _health.failures >= AD5593R_OFFLINE_AFTER) {
+    _health.online = 0;
+    _health.last_attempt = millis();
+    AD5593R_LOG_ERROR(AD5593R_EVENT_OFFLINE, 0xff, _health.failures);
+  }
+  return status;
+}
+
+void AD5593R::set_retries(byte retries, uint16_t backoff) {
+  _retries = retries;
+  _backoff = backoff;
+}
+
+AD5593R_Status AD5593R::probe() {
+  //a lone pointer byte changes nothing on the device
+  _health.last_attempt = millis() - AD5593R_OFFLINE_PROBE_MS;
+  _select();
+  AD5593R_Status status = _write_pointer(_ADAC_NULL);
+  _deselect();
+  return status;
+}
+
+AD5593R_Status AD5593R::reset() {
+  AD5593R_STATS_SCOPE(AD5593R_OP_CONFIGURE);
+  _publish_scope publish(*this);
+  _select();
+  AD5593R_Status status = _write_register(_ADAC_SOFT_RESET, _ADAC_RESET_MSBS, _ADAC_RESET_LSBS);
+  _deselect();
+  if (status != AD5593R_OK) return status;
+  delayMicroseconds(AD5593R_RESET_DELAY);
+  _reset_shadow();
+  return AD5593R_OK;
+}
+
+void AD5593R::_reset_shadow() {
+  if (_registers[_ADAC_POWER_REF_CTRL] & (_ADAC_VREF_ON << 8)) _Vref = -1;
+  _ADC_2x_mode = 0;
+  _DAC_2x_mode = 0;
+  _temperature_in_sequence = 0;
+  _update_scales();
+
+  //after a reset every register is known to hold its power-on value
+  for (int i = 0; i < 16; i++) {
+    _registers[i] = 0x0000;
+  }
+  _registers[_ADAC_PULL_DOWN] = 0x00ff;
+  _registers_valid = 0x3fff;
+  _registers_dirty = 0;
+  _read_pointer = _ADAC_NULL;
 
-  _a0 = a0;
-  _GPRC_msbs = 0x00;
-  _GPRC_lsbs = 0x00;
-  _PCR_msbs = 0x00;
-  _PCR_lsbs = 0x00;
-  //intializing the configuration struct.
   for (int i = 0; i < _num_of_channels; i++) {
     config.ADCs[i] = 0;
     config.DACs[i] = 0;
+    config.GPIs[i] = 0;
+    config.GPOs[i] = 0;
+    values.DACs[i] = -1;
+    values.DAC_codes[i] = 0;
+    values.GPO_writes[i] = 0;
   }
+  _values_changed = 1;
+}
 
+void AD5593R::save_state(AD5593R_State* state) const {
+  for (int i = 0; i < 16; i++) {
+    state->registers[i] = _register(i);
+  }
+  state->valid = _registers_valid | _registers_dirty;
   for (int i = 0; i < _num_of_channels; i++) {
-    values.ADCs[i] = -1;
-    values.DACs[i] = -1;
+    state->DAC_codes[i] = values.DAC_codes[i];
   }
+  state->Vref_uV = _Vref > 0 ? uint32_t(_Vref * 1e6f + 0.5f) : 0;
+  state->flags = (_ADC_2x_mode ? AD5593R_STATE_ADC_2X : 0) | (_DAC_2x_mode ? AD5593R_STATE_DAC_2X : 0) |
+                 (_temperature_in_sequence ? AD5593R_STATE_TEMPERATURE : 0);
+}
 
-  //this allows for multiple devices on the same bus, see header.
-  if (_a0 > -1) {
-    pinMode(_a0, OUTPUT);
-    digitalWrite(_a0, HIGH);
+AD5593R_Status AD5593R::restore_state(const AD5593R_State& state, bool verify) {
+  AD5593R_STATS_SCOPE(AD5593R_OP_CONFIGURE);
+  _publish_scope publish(*this);
+  AD5593R_Status status = reset();
+  if (status != AD5593R_OK) return status;
+
+  _Vref = state.Vref_uV > 0 ? state.Vref_uV * 1e-6f : -1;
+  _ADC_2x_mode = state.flags & AD5593R_STATE_ADC_2X;
+  _DAC_2x_mode = state.flags & AD5593R_STATE_DAC_2X;
+  _temperature_in_sequence = state.flags & AD5593R_STATE_TEMPERATURE;
+  _update_scales();
+
+  //the reference and ranges first, then the DAC codes (0xff), then the GPO levels and the pin roles
+  static const byte order[] = {
+    _ADAC_POWER_REF_CTRL, _ADAC_GP_CONTROL, 0xff, _ADAC_GPIO_WR_DATA, _ADAC_OPEN_DRAIN_CFG, _ADAC_PULL_DOWN,
+    _ADAC_THREE_STATE, _ADAC_ADC_CONFIG, _ADAC_DAC_CONFIG, _ADAC_GPIO_RD_CONFIG, _ADAC_GPIO_WR_CONFIG
+  };
+  byte DACs = (state.valid & (1 << _ADAC_DAC_CONFIG)) ? state.registers[_ADAC_DAC_CONFIG] : 0;
+  byte frames[3 * (sizeof(order) + 8)];
+  size_t length = 0;
+  uint16_t restored = 0;
+  for (byte address : order) {
+    if (address == 0xff) {
+      for (int i = 0; i < _num_of_channels; i++) {
+        //the DAC input registers are 0 after the reset
+        if (!(DACs & (1 << i)) || _DAC_code(i, state.DAC_codes[i]) == 0) continue;
+        encode_DAC_frame(i, _DAC_code(i, state.DAC_codes[i]), frames + length);
+        length += 3;
+      }
+      continue;
+    }
+    if (!(state.valid & (1 << address)) || state.registers[address] == _registers[address]) continue;
+    frames[length++] = address;
+    frames[length++] = state.registers[address] >> 8;
+    frames[length++] = state.registers[address] & 0xff;
+    restored |= 1 << address;
   }
-  Wire.begin();
+  if (length > 0) {
+    _select();
+    status = _write_frames(frames, length);
+    _deselect();
+  }
+
+  //the driver side follows the registers
+  for (int i = 0; i < _num_of_channels; i++) {
+    config.ADCs[i] = (_registers[_ADAC_ADC_CONFIG] >> i) & 1;
+    config.DACs[i] = (_registers[_ADAC_DAC_CONFIG] >> i) & 1;
+    config.GPIs[i] = (_registers[_ADAC_GPIO_RD_CONFIG] >> i) & 1;
+    config.GPOs[i] = (_registers[_ADAC_GPIO_WR_CONFIG] >> i) & 1;
+    values.GPO_writes[i] = (_registers[_ADAC_GPIO_WR_DATA] >> i) & 1;
+    if (DACs & (1 << i)) {
+      values.DAC_codes[i] = state.DAC_codes[i];
+      values.DACs[i] = _DAC_codes_per_volt > 0 ? state.DAC_codes[i] / _DAC_codes_per_volt : -1;
+    }
+  }
+  _values_changed = 1;
+  if (status != AD5593R_OK || !verify) return status;
+
+  _select();
+  for (byte address = 0; address < 16; address++) {
+    if ((restored & (1 << address)) && !_verify(_ADAC_REG_READ | address, _registers[address])) {
+      //the register is written again by the next change
+      _registers_valid &= ~(1 << address);
+      status = AD5593R_ERROR_VERIFY;
+    }
+  }
+  for (int i = 0; i < _num_of_channels; i++) {
+    if ((DACs & (1 << i)) && !_verify(_ADAC_DAC_READ | i, _DAC_code(i, state.DAC_codes[i]))) {
+      status = AD5593R_ERROR_VERIFY;
+    }
+  }
+  _deselect();
+  return status;
 }
 
+bool AD5593R::_verify(byte pointer, uint16_t value) {
+  byte buffer[2];
+  if (_write_pointer(pointer) != AD5593R_OK || _read(buffer, 2) < 2) return 0;
+  uint16_t word = (uint16_t(buffer[0]) << 8) | buffer[1];
+  //a DAC readback carries a flag and the channel above the 12-bit code
+  if ((pointer & 0xf0) == _ADAC_DAC_READ) word &= 0x0fff;
+  return word == value;
+}
 
-//int AD5593R::configure_pins(*configuration config){
 
-//}
+AD5593R_Status AD5593R::configure_pins(configuration* pins) {
+  AD5593R_STATS_SCOPE(AD5593R_OP_CONFIGURE);
+  byte ADCs = 0;
+  byte DACs = 0;
+  byte GPIs = 0;
+  byte GPOs = 0;
+  for (int i = 0; i < _num_of_channels; i++) {
+    int roles = pins->ADCs[i] + pins->DACs[i] + pins->GPIs[i] + pins->GPOs[i];
+    if (roles > 1) {
+      AD5593R_LOG_ERROR(AD5593R_EVENT_DOUBLE_ASSIGNED, i, 0);
+      return AD5593R_ERROR_ROLE;
+    }
+    ADCs |= pins->ADCs[i] << i;
+    DACs |= pins->DACs[i] << i;
+    GPIs |= pins->GPIs[i] << i;
+    GPOs |= pins->GPOs[i] << i;
+  }
+  //unused pins are pulled down, as they are after a reset
+  byte pull_downs = ~(ADCs | DACs | GPIs | GPOs);
+
+  //each register is written at most once, and only if its value changes,
+  //the changed registers all go out in a single transaction
+  begin_update();
+  _update_register(_ADAC_ADC_CONFIG, ADCs);
+  _update_register(_ADAC_DAC_CONFIG, DACs);
+  _update_register(_ADAC_GPIO_RD_CONFIG, GPIs);
+  _update_register(_ADAC_GPIO_WR_CONFIG, GPOs);
+  _update_register(_ADAC_PULL_DOWN, pull_downs);
+  _update_register(_ADAC_THREE_STATE, 0x00);
+  AD5593R_Status status = end_update();
+  if (status != AD5593R_OK) return status;
+
+  config = *pins;
+  AD5593R_LOG_INFO(AD5593R_EVENT_PINS_CONFIGURED, 0xff, (uint16_t(DACs) << 8) | ADCs);
+  return AD5593R_OK;
+}
 
-void AD5593R::enable_internal_Vref() {
+AD5593R_Status AD5593R::_add_pins(byte address, bool* channels, bool* roles) {
+  AD5593R_STATS_SCOPE(AD5593R_OP_CONFIGURE);
+  byte channel_bits = 0;
+  for (int i = 0; i < _num_of_channels; i++) {
+    if (channels[i] == 1) channel_bits |= 1 << i;
+  }
+  _select();
+  AD5593R_Status status = _update_register(address, _register(address) | channel_bits);
+  _deselect();
+  //the pins only take their role once the device has it
+  if (status != AD5593R_OK) return status;
+  for (int i = 0; i < _num_of_channels; i++) {
+    if (channel_bits & (1 << i)) {
+      roles[i] = 1;
+      AD5593R_LOG_INFO(AD5593R_EVENT_PIN_ROLE, i, address);
+    }
+  }
+  return AD5593R_OK;
+}
+
+AD5593R_Status AD5593R::enable_internal_Vref() {
   //Enable selected device for writing
-  _Vref = 2.5;
-  _ADC_max = _Vref;
-  _DAC_max = _Vref;
-  if (_a0 > -1) digitalWrite(_a0, LOW);
+  _select();
 
   //check if the on bit is already fliped on
-  if ((_PCR_msbs & 0x02) != 0x02) {
-    _PCR_msbs = _PCR_msbs ^ 0x02;
-  }
-  Wire.beginTransmission(_i2c_address);
-  Wire.write(_ADAC_POWER_REF_CTRL);
-  Wire.write(_PCR_msbs);
-  Wire.write(_PCR_lsbs);
-  Wire.endTransmission();
+  AD5593R_Status status = _update_register(_ADAC_POWER_REF_CTRL, _register(_ADAC_POWER_REF_CTRL) | (_ADAC_VREF_ON << 8));
 
   //Disable selected device for writing
-  if (_a0 > -1) digitalWrite(_a0, HIGH);
-  AD5593R_PRINTLN("Internal Reference on.");
+  _deselect();
+  //the scales only change once the device uses the reference
+  if (status != AD5593R_OK) return status;
+  _Vref = 2.5;
+  _update_scales();
+  AD5593R_LOG_INFO(AD5593R_EVENT_VREF, 0xff, 1);
+  return AD5593R_OK;
 }
 
-void AD5593R::disable_internal_Vref() {
+AD5593R_Status AD5593R::disable_internal_Vref() {
   //Enable selected device for writing
-  _Vref = -1;
-  _ADC_max = _Vref;
-  _DAC_max = _Vref;
-  if (_a0 > -1) digitalWrite(_a0, LOW);
+  _select();
   //check if the on bit is already fliped off
-  if ((_PCR_msbs & 0x02) == 0x02) {
-    _PCR_msbs = _PCR_msbs ^ 0x02;
-  }
-  Wire.beginTransmission(_i2c_address);
-  Wire.write(_ADAC_POWER_REF_CTRL);
-  Wire.write(_PCR_msbs);
-  Wire.write(_PCR_lsbs);
-  Wire.endTransmission();
+  AD5593R_Status status = _update_register(_ADAC_POWER_REF_CTRL, _register(_ADAC_POWER_REF_CTRL) & ~(_ADAC_VREF_ON << 8));
 
   //Disable selected device for writing
-  if (_a0 > -1) digitalWrite(_a0, HIGH);
-  AD5593R_PRINTLN("Internal Reference off.");
+  _deselect();
+  if (status != AD5593R_OK) return status;
+  _Vref = -1;
+  _update_scales();
+  AD5593R_LOG_INFO(AD5593R_EVENT_VREF, 0xff, 0);
+  return AD5593R_OK;
 }
 
-void AD5593R::set_ADC_max_2x_Vref() {
+AD5593R_Status AD5593R::set_ADC_max_2x_Vref() {
   //Enable selected device for writing
-  _ADC_max = 2 * _Vref;
-  if (_a0 > -1) digitalWrite(_a0, LOW);
+  _select();
   //check if 2x bit is on in the general purpose register
-  if ((_GPRC_lsbs & 0x20) != 0x20) {
-    _GPRC_lsbs = _GPRC_lsbs ^ 0x20;
-  }
-  Wire.beginTransmission(_i2c_address);
-  Wire.write(_ADAC_GP_CONTROL);
-  Wire.write(_GPRC_msbs);
-  Wire.write(_GPRC_lsbs);
-  Wire.endTransmission();
+  AD5593R_Status status = _update_register(_ADAC_GP_CONTROL, _register(_ADAC_GP_CONTROL) | _ADAC_ADC_RANGE_2X);
 
   //Disable selected device for writing
-  if (_a0 > -1) digitalWrite(_a0, HIGH);
-  AD5593R_PRINTLN("ADC max voltage = 2xVref");
+  _deselect();
+  if (status != AD5593R_OK) return status;
   _ADC_2x_mode = 1;
+  _update_scales();
+  AD5593R_LOG_INFO(AD5593R_EVENT_ADC_RANGE, 0xff, 2);
+  return AD5593R_OK;
 }
 
-void AD5593R::set_ADC_max_1x_Vref() {
+AD5593R_Status AD5593R::set_ADC_max_1x_Vref() {
   //Enable selected device for writing
-  _ADC_max = _Vref;
-  if (_a0 > -1) digitalWrite(_a0, LOW);
+  _select();
 
-  if ((_GPRC_lsbs & 0x20) == 0x20) {
-    _GPRC_lsbs = _GPRC_lsbs ^ 0x20;
-  }
-  Wire.beginTransmission(_i2c_address);
-  Wire.write(_ADAC_GP_CONTROL);
-  Wire.write(_GPRC_msbs);
-  Wire.write(_GPRC_lsbs);
-  Wire.endTransmission();
+  AD5593R_Status status = _update_register(_ADAC_GP_CONTROL, _register(_ADAC_GP_CONTROL) & ~_ADAC_ADC_RANGE_2X);
 
   //Disable selected device for writing
-  if (_a0 > -1) digitalWrite(_a0, HIGH);
-  AD5593R_PRINTLN("ADC max voltage = 1xVref");
+  _deselect();
+  if (status != AD5593R_OK) return status;
   _ADC_2x_mode = 0;
+  _update_scales();
+  AD5593R_LOG_INFO(AD5593R_EVENT_ADC_RANGE, 0xff, 1);
+  return AD5593R_OK;
 }
 
-void AD5593R::set_DAC_max_2x_Vref() {
+AD5593R_Status AD5593R::set_DAC_max_2x_Vref() {
   //Enable selected device for writing
-  _DAC_max = 2 * _Vref;
-  if (_a0 > -1) digitalWrite(_a0, LOW);
+  _select();
 
-  if ((_GPRC_lsbs & 0x10) != 0x10) {
-    _GPRC_lsbs = _GPRC_lsbs ^ 0x10;
-  }
-  Wire.beginTransmission(_i2c_address);
-  Wire.write(_ADAC_GP_CONTROL);
-  Wire.write(_GPRC_msbs);
-  Wire.write(_GPRC_lsbs);
-  Wire.endTransmission();
+  AD5593R_Status status = _update_register(_ADAC_GP_CONTROL, _register(_ADAC_GP_CONTROL) | _ADAC_DAC_RANGE_2X);
 
   //Disable selected device for writing
-  if (_a0 > -1) digitalWrite(_a0, HIGH);
-  AD5593R_PRINTLN("DAC max voltage = 2xVref");
+  _deselect();
+  if (status != AD5593R_OK) return status;
   _DAC_2x_mode = 1;
+  _update_scales();
+  AD5593R_LOG_INFO(AD5593R_EVENT_DAC_RANGE, 0xff, 2);
+  return AD5593R_OK;
 }
 
-void AD5593R::set_DAC_max_1x_Vref() {
+AD5593R_Status AD5593R::set_DAC_max_1x_Vref() {
   //Enable selected device for writing
-  _DAC_max = _Vref;
-  if (_a0 > -1) digitalWrite(_a0, LOW);
+  _select();
 
-  if ((_GPRC_lsbs & 0x10) == 0x10) {
-    _GPRC_lsbs = _GPRC_lsbs ^ 0x10;
-  }
-  Wire.beginTransmission(_i2c_address);
-  Wire.write(_ADAC_GP_CONTROL);
-  Wire.write(_GPRC_msbs);
-  Wire.write(_GPRC_lsbs);
-  Wire.endTransmission();
+  AD5593R_Status status = _update_register(_ADAC_GP_CONTROL, _register(_ADAC_GP_CONTROL) & ~_ADAC_DAC_RANGE_2X);
 
   //Disable selected device for writing
-  if (_a0 > -1) digitalWrite(_a0, HIGH);
-  AD5593R_PRINTLN("ADC max voltage = 1xVref");
+  _deselect();
+  if (status != AD5593R_OK) return status;
   _DAC_2x_mode = 0;
+  _update_scales();
+  AD5593R_LOG_INFO(AD5593R_EVENT_DAC_RANGE, 0xff, 1);
+  return AD5593R_OK;
 }
 
 void AD5593R::set_Vref(float Vref) {
   _Vref = Vref;
-  if (_ADC_2x_mode == 0) {
-    _ADC_max = Vref;
-  }
-  else {
-    _ADC_max = 2 * Vref;
-  }
+  _update_scales();
+}
 
-  if (_DAC_2x_mode == 0) {
-    _DAC_max = Vref;
-  }
-  else {
-    _DAC_max = 2 * Vref;
+void AD5593R::_update_scales() {
+  if (_Vref <= 0) {
+    _ADC_max = -1;
+    _DAC_max = -1;
+    _ADC_max_mV = 0;
+    _DAC_max_mV = 0;
+    _ADC_mV_per_code = 0;
+    _DAC_codes_per_mV = 0;
+    _ADC_volts_per_code = 0;
+    _DAC_codes_per_volt = 0;
+    _temperature_zero = 0;
+    _temperature_mC_per_code = 0;
+    return;
   }
+  _ADC_max = _ADC_2x_mode ? 2 * _Vref : _Vref;
+  _DAC_max = _DAC_2x_mode ? 2 * _Vref : _Vref;
+  _ADC_max_mV = uint32_t(_ADC_max * 1000 + 0.5f);
+  _DAC_max_mV = uint32_t(_DAC_max * 1000 + 0.5f);
+
+  //16 fractional bits, the products stay below 2^32 for any input in range
+  _ADC_mV_per_code = ((_ADC_max_mV << 16) + 2047) / 4095;
+  _DAC_codes_per_mV = ((uint32_t(4095) << 16) + _DAC_max_mV / 2) / _DAC_max_mV;
+
+  _ADC_volts_per_code = _ADC_max / 4095;
+  _DAC_codes_per_volt = 4095 / _DAC_max;
+
+  //data sheet: T = 25 + (code - (0.5 / Vref) * 4095) / (2.654 * (2.5 / Vref)) in the 1x range,
+  //T = 25 + (code - (0.5 / (2 * Vref)) * 4095) / (1.327 * (2.5 / Vref)) in the 2x range
+  float zero_code = (_ADC_2x_mode ? 0.5f / (2 * _Vref) : 0.5f / _Vref) * 4095;
+  float codes_per_degree = (_ADC_2x_mode ? 1.327f : 2.654f) * (2.5f / _Vref);
+  _temperature_zero = int32_t(zero_code * 16 + 0.5f);
+  _temperature_mC_per_code = int32_t(1000 * 65536 / codes_per_degree + 0.5f);
+}
 
+void AD5593R::enable_temperature() {
+  _temperature_in_sequence = 1;
+  //a running stream picks up the temperature when it is started again
+  AD5593R_LOG_INFO(AD5593R_EVENT_TEMPERATURE, 0xff, 1);
 }
 
-void AD5593R::configure_DAC(byte channel) {
-  if (_a0 > -1) digitalWrite(_a0, LOW);
-  config.DACs[channel] = 1;
-  byte channel_byte = 1 << channel;
-  //check to see if the channel is a DAC already
-  if ((_DAC_config & channel_byte) != channel_byte) {
-    _DAC_config = _DAC_config ^ channel_byte;
-  }
-  Wire.beginTransmission(_i2c_address);
-  Wire.write(_ADAC_DAC_CONFIG);
-  Wire.write(0x0);
-  Wire.write(_DAC_config);
-  Wire.endTransmission();
+void AD5593R::disable_temperature() {
+  _temperature_in_sequence = 0;
+  AD5593R_LOG_INFO(AD5593R_EVENT_TEMPERATURE, 0xff, 0);
+}
 
-  if (_a0 > -1) digitalWrite(_a0, HIGH);
-  AD5593R_PRINT("Channel ");
-  AD5593R_PRINT(channel);
-  AD5593R_PRINTLN(" is configured as a DAC");
+int32_t AD5593R::temperature_code_to_mC(uint16_t code) {
+  //the offset from 25 degrees, in codes with 4 fractional bits, times millidegrees per code with 16
+  int64_t offset = (int32_t(code) << 4) - _temperature_zero;
+  return 25000 + int32_t((offset * _temperature_mC_per_code) >> 20);
 }
 
+uint16_t AD5593R::DAC_mV_to_code(uint32_t millivolts) {
+  if (millivolts >= _DAC_max_mV) return 4095;
+  return (millivolts * _DAC_codes_per_mV + 0x8000) >> 16;
+}
 
-void AD5593R::configure_DACs(bool* channels) {
-  for (size_t i = 0; i < _num_of_channels; i++) {
-    if (channels[i] == 1) {
-      configure_DAC(i);
-    }
-  }
+uint32_t AD5593R::ADC_code_to_mV(uint16_t code) {
+  return (uint32_t(code & 0x0fff) * _ADC_mV_per_code + 0x8000) >> 16;
+}
+
+AD5593R_Status AD5593R::configure_DAC(byte channel) {
+  bool channels[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+  channels[channel] = 1;
+  return configure_DACs(channels);
 }
 
 
-int AD5593R::write_DAC(byte channel, float voltage) {
+AD5593R_Status AD5593R::configure_DACs(bool* channels) {
+  return _add_pins(_ADAC_DAC_CONFIG, channels, config.DACs);
+}
+
+
+AD5593R_Status AD5593R::write_DAC(byte channel, float voltage) {
+  AD5593R_STATS_SCOPE(AD5593R_OP_WRITE_DAC);
+  _publish_scope publish(*this);
   //error checking
   if (config.DACs[channel] == 0) {
-    AD5593R_PRINT("ERROR! Channel ");
-    AD5593R_PRINT(channel);
-    AD5593R_PRINTLN(" is not a DAC");
-    return -1;
+    AD5593R_LOG_ERROR(AD5593R_EVENT_NOT_A_DAC, channel, 0);
+    return AD5593R_ERROR_ROLE;
   }
   if (_DAC_max == -1) {
-    AD5593R_PRINTLN("Vref, or DAC_max is not defined");
-    return -2;
+    AD5593R_LOG_ERROR(AD5593R_EVENT_NO_VREF, 0xff, 0);
+    return AD5593R_ERROR_NO_VREF;
   }
-  if (voltage > _DAC_max) {
-    AD5593R_PRINTLN("Vref, or DAC_max is lower than set voltage");
-    return -3;
+  if (voltage > _DAC_max || voltage < 0) {
+    AD5593R_LOG_ERROR(AD5593R_EVENT_OUT_OF_RANGE, channel, 0);
+    return AD5593R_ERROR_RANGE;
   }
 
-  if (_a0 > -1) digitalWrite(_a0, LOW);
-
-  //find the binary representation of the
-  unsigned int data_bits = (voltage / _DAC_max) * 4095;
-
-  //extract the 4 most signifigant bits, and move them down to the bottom
-  byte data_msbs = (data_bits & 0xf00) >> 8;
-  byte lsbs = (data_bits & 0x0ff);
-  //place the channel data in the most signifigant bits
-  byte msbs = (B10000000 | (channel << 4)) | data_msbs;
+  //find the binary representation of the voltage, the scale is precomputed in _update_scales()
+  AD5593R_Status status = write_DAC_code(channel, uint16_t(voltage * _DAC_codes_per_volt + 0.5f));
+  if (status != AD5593R_OK) return status;
+  values.DACs[channel] = voltage;
+  _values_changed = 1;
+  return AD5593R_OK;
+}
 
-  Wire.beginTransmission(_i2c_address);
-  Wire.write((_ADAC_DAC_WRITE | channel));
-  Wire.write(msbs);
-  Wire.write(lsbs);
-  Wire.endTransmission();
+AD5593R_Status AD5593R::write_DAC_code(byte channel, uint16_t code) {
+  AD5593R_STATS_SCOPE(AD5593R_OP_WRITE_DAC);
+  _publish_scope publish(*this);
+  if (config.DACs[channel] == 0) {
+    AD5593R_LOG_ERROR(AD5593R_EVENT_NOT_A_DAC, channel, 0);
+    return AD5593R_ERROR_ROLE;
+  }
+  if (code > 4095) {
+    AD5593R_LOG_ERROR(AD5593R_EVENT_OUT_OF_RANGE, channel, code);
+    return AD5593R_ERROR_RANGE;
+  }
 
-  AD5593R_PRINT("Channel ");
-  AD5593R_PRINT(channel);
-  AD5593R_PRINT(" is set to ");
-  AD5593R_PRINT(voltage);
-  AD5593R_PRINTLN(" Volts");
-  if (_a0 > -1) digitalWrite(_a0, HIGH);
-  values.DACs[channel] = voltage;
-  return 1;
+  byte frame[3];
+  encode_DAC_frame(channel, _DAC_code(channel, code), frame);
+  _select();
+  AD5593R_Status status = _write_frames(frame, 3);
+  _deselect();
+  if (status != AD5593R_OK) return status;
+  values.DAC_codes[channel] = code;
+  _values_changed = 1;
+  AD5593R_LOG_TRACE(AD5593R_EVENT_DAC_WRITE, channel, code);
+  return AD5593R_OK;
 }
 
-void AD5593R::configure_ADC(byte channel) {
-  if (_a0 > -1) digitalWrite(_a0, LOW);
-  config.ADCs[channel] = 1;
-  byte channel_byte = 1 << channel;
-  //check to see if the channel is a ADC already
-  if ((_ADC_config & channel_byte) != channel_byte) {
-    _ADC_config = _ADC_config ^ channel_byte;
+AD5593R_Status AD5593R::write_DAC_mV(byte channel, uint32_t millivolts) {
+  AD5593R_STATS_SCOPE(AD5593R_OP_WRITE_DAC);
+  if (_DAC_max_mV == 0) {
+    AD5593R_LOG_ERROR(AD5593R_EVENT_NO_VREF, 0xff, 0);
+    return AD5593R_ERROR_NO_VREF;
+  }
+  if (millivolts > _DAC_max_mV) {
+    AD5593R_LOG_ERROR(AD5593R_EVENT_OUT_OF_RANGE, channel, millivolts > 0xffff ? 0xffff : millivolts);
+    return AD5593R_ERROR_RANGE;
   }
-  Wire.beginTransmission(_i2c_address);
-  Wire.write(_ADAC_ADC_CONFIG);
-  Wire.write(0x0);
-  Wire.write(_ADC_config);
-  Wire.endTransmission();
+  return write_DAC_code(channel, DAC_mV_to_code(millivolts));
+}
 
-  if (_a0 > -1) digitalWrite(_a0, HIGH);
-  AD5593R_PRINT("Channel ");
-  AD5593R_PRINT(channel);
-  AD5593R_PRINTLN(" is configured as a ADC");
+AD5593R_Status AD5593R::write_DACs(float* voltages) {
+  AD5593R_STATS_SCOPE(AD5593R_OP_WRITE_DACS);
+  _publish_scope publish(*this);
+  if (_DAC_max == -1) {
+    AD5593R_LOG_ERROR(AD5593R_EVENT_NO_VREF, 0xff, 0);
+    return AD5593R_ERROR_NO_VREF;
+  }
+  uint16_t codes[8];
+  for (int i = 0; i < _num_of_channels; i++) {
+    codes[i] = 0;
+    if (config.DACs[i] == 0) continue;
+    if (voltages[i] > _DAC_max || voltages[i] < 0) {
+      AD5593R_LOG_ERROR(AD5593R_EVENT_OUT_OF_RANGE, i, 0);
+      return AD5593R_ERROR_RANGE;
+    }
+    codes[i] = uint16_t(voltages[i] * _DAC_codes_per_volt + 0.5f);
+  }
+  AD5593R_Status status = write_DAC_codes(codes);
+  if (status != AD5593R_OK) return status;
+  for (int i = 0; i < _num_of_channels; i++) {
+    if (config.DACs[i] == 1) values.DACs[i] = voltages[i];
+  }
+  return AD5593R_OK;
 }
 
-void AD5593R::configure_ADCs(bool* channels) {
-  for (size_t i = 0; i < _num_of_channels; i++) {
-    if (channels[i] == 1) {
-      configure_ADC(i);
+AD5593R_Status AD5593R::write_DAC_codes(const uint16_t* codes) {
+  AD5593R_STATS_SCOPE(AD5593R_OP_WRITE_DACS);
+  _publish_scope publish(*this);
+  //hold the outputs, stage every channel in its input register, then load them all at once
+  byte frames[3 * (8 + 2)] = {_ADAC_LDAC_MODE, 0x00, _ADAC_LDAC_HOLD};
+  size_t length = 3;
+  for (int i = 0; i < _num_of_channels; i++) {
+    if (config.DACs[i] == 0) continue;
+    if (codes[i] > 4095) {
+      AD5593R_LOG_ERROR(AD5593R_EVENT_OUT_OF_RANGE, i, codes[i]);
+      return AD5593R_ERROR_RANGE;
     }
+    encode_DAC_frame(i, _DAC_code(i, codes[i]), frames + length);
+    length += 3;
+  }
+  if (length == 3) {
+    AD5593R_LOG_ERROR(AD5593R_EVENT_NO_DACS, 0xff, 0);
+    return AD5593R_ERROR_ROLE;
+  }
+  frames[length++] = _ADAC_LDAC_MODE;
+  frames[length++] = 0x00;
+  frames[length++] = _ADAC_LDAC_LOAD;
+
+  _select();
+  AD5593R_Status status = _write_frames(frames, length);
+  _deselect();
+  if (status != AD5593R_OK) return status;
+  for (int i = 0; i < _num_of_channels; i++) {
+    if (config.DACs[i] == 0) continue;
+    values.DAC_codes[i] = codes[i];
+    AD5593R_LOG_TRACE(AD5593R_EVENT_DAC_WRITE, i, codes[i]);
   }
+  _values_changed = 1;
+  return AD5593R_OK;
+}
+
+void AD5593R::encode_DAC_frame(byte channel, uint16_t code, byte* frame) {
+  //the pointer byte selects the channel, the 12 data bits follow in the next two bytes
+  frame[0] = _ADAC_DAC_WRITE | channel;
+  //extract the 4 most signifigant bits, and place the channel data above them
+  frame[1] = (0b10000000 | (channel << 4)) | ((code & 0xf00) >> 8);
+  frame[2] = code & 0x0ff;
+}
+
+AD5593R_Status AD5593R::configure_ADC(byte channel) {
+  bool channels[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+  channels[channel] = 1;
+  return configure_ADCs(channels);
+}
+
+AD5593R_Status AD5593R::configure_ADCs(bool* channels) {
+  return _add_pins(_ADAC_ADC_CONFIG, channels, config.ADCs);
 }
 
 
 float AD5593R::read_ADC(byte channel) {
+  AD5593R_STATS_SCOPE(AD5593R_OP_READ_ADC);
+  _publish_scope publish(*this);
   if (config.ADCs[channel] == 0) {
-    AD5593R_PRINT("ERROR! Channel ");
-    AD5593R_PRINT(channel);
-    AD5593R_PRINTLN(" is not an ADC");
-    return -1;
+    AD5593R_LOG_ERROR(AD5593R_EVENT_NOT_AN_ADC, channel, 0);
+    return AD5593R_ERROR_ROLE;
   }
   if (_ADC_max == -1) {
-    AD5593R_PRINTLN("Vref, or ADC_max is not defined");
-    return -2;
+    AD5593R_LOG_ERROR(AD5593R_EVENT_NO_VREF, 0xff, 0);
+    return AD5593R_ERROR_NO_VREF;
   }
-  if (_a0 > -1) digitalWrite(_a0, LOW);
-
-  Wire.beginTransmission(_i2c_address);
-  Wire.write(_ADAC_ADC_SEQUENCE);
-  Wire.write(0x02);
-  Wire.write(byte(1 << channel));
-  Wire.endTransmission();
+  int data_bits = read_ADC_code(channel);
+  if (data_bits < 0) return data_bits;
+  float data = data_bits * _ADC_volts_per_code;
+  values.ADCs[channel] = data;
+  _values_changed = 1;
+  return data;
+}
 
+int AD5593R::read_ADC_code(byte channel) {
+  AD5593R_STATS_SCOPE(AD5593R_OP_READ_ADC);
+  _publish_scope publish(*this);
+  if (config.ADCs[channel] == 0) {
+    AD5593R_LOG_ERROR(AD5593R_EVENT_NOT_AN_ADC, channel, 0);
+    return AD5593R_ERROR_ROLE;
+  }
+  _select();
+
+  AD5593R_Status status = _write_register(_ADAC_ADC_SEQUENCE, 0x02, byte(1 << channel));
+  if (status == AD5593R_OK) status = _write_pointer(_ADAC_ADC_READ);
+
+  byte buffer[2];
+  size_t received = 0;
+  if (status == AD5593R_OK) received = _read(buffer, 2);
+  _deselect();
+  //a failed read returns its error, never a code of 0
+  if (status != AD5593R_OK) return status;
+  if (received < 2) return _read_error();
+  unsigned int data_bits = _ADC_code(channel, ((buffer[0] & 0x0f) << 8) | buffer[1]);
+  values.ADC_codes[channel] = data_bits;
+  _values_changed = 1;
+  AD5593R_LOG_TRACE(AD5593R_EVENT_ADC_READ, channel, data_bits);
+  if (_monitor) _monitor->_ADC(channel, data_bits);
+  return data_bits;
+}
 
-  Wire.beginTransmission(_i2c_address);
-  Wire.write(_ADAC_ADC_READ);
-  Wire.endTransmission();
+int32_t AD5593R::read_ADC_mV(byte channel) {
+  AD5593R_STATS_SCOPE(AD5593R_OP_READ_ADC);
+  if (config.ADCs[channel] == 0) {
+    AD5593R_LOG_ERROR(AD5593R_EVENT_NOT_AN_ADC, channel, 0);
+    return AD5593R_ERROR_ROLE;
+  }
+  if (_ADC_max_mV == 0) {
+    AD5593R_LOG_ERROR(AD5593R_EVENT_NO_VREF, 0xff, 0);
+    return AD5593R_ERROR_NO_VREF;
+  }
+  int code = read_ADC_code(channel);
+  if (code < 0) return code;
+  return ADC_code_to_mV(code);
+}
 
-  unsigned int data_bits = 0;
+float* AD5593R::read_ADCs() {
+  AD5593R_STATS_SCOPE(AD5593R_OP_READ_ADCS);
+  _publish_scope publish(*this);
+  if (_ADC_max == -1) {
+    AD5593R_LOG_ERROR(AD5593R_EVENT_NO_VREF, 0xff, 0);
+    return values.ADCs;
+  }
+  byte channels = read_ADC_codes(values.ADC_codes);
 
-  Wire.requestFrom(int(_i2c_address), int(2), int(1));
-  if (Wire.available()) data_bits = (Wire.read() & 0x0f) << 8;
-  if (Wire.available()) data_bits = data_bits | Wire.read();
-  if (_a0 > -1) digitalWrite(_a0, HIGH);
-  float data = _ADC_max * (data_bits) / 4095;
+  for (int channel = 0; channel < _num_of_channels; channel++) {
+    if ((channels & (1 << channel)) == 0) continue;
+    values.ADCs[channel] = values.ADC_codes[channel] * _ADC_volts_per_code;
+  }
+  if (_temperature_in_sequence) {
+    values.temperature = temperature_code_to_mC(values.temperature_code) * 0.001f;
+  }
+  return values.ADCs;
+}
 
-  AD5593R_PRINT("Channel ");
-  AD5593R_PRINT(channel);
-  AD5593R_PRINT(" reads ");
-  AD5593R_PRINT(data);
-  AD5593R_PRINTLN(" Volts");
-  return data;
+byte AD5593R::read_ADC_codes(uint16_t* codes) {
+  byte channels = 0;
+  for (int i = 0; i < _num_of_channels; i++) {
+    if (config.ADCs[i] == 1) channels |= 1 << i;
+  }
+  return read_ADC_codes(channels, codes);
 }
 
-float* AD5593R::read_ADCs() {
-  for (size_t i = 0; i < _num_of_channels; i++) {
-    if (config.ADCs[i] == 1) {
-      read_ADC(i);
+byte AD5593R::read_ADC_codes(byte channels, uint16_t* codes) {
+  AD5593R_STATS_SCOPE(AD5593R_OP_READ_ADCS);
+  _publish_scope publish(*this);
+  size_t num_of_ADCs = 0;
+  for (int i = 0; i < _num_of_channels; i++) {
+    if (channels & (1 << i)) {
+      if (config.ADCs[i] == 0) {
+        AD5593R_LOG_ERROR(AD5593R_EVENT_NOT_AN_ADC, i, 0);
+        return 0;
+      }
+      num_of_ADCs++;
     }
   }
-  return values.ADCs;
+  //the temperature indicator is converted last, after the ADC channels
+  byte sequence_msbs = _temperature_in_sequence ? _ADAC_SEQUENCE_TEMP : 0x00;
+  size_t num_of_results = num_of_ADCs + (_temperature_in_sequence ? 1 : 0);
+  if (num_of_results == 0) return 0;
+  _select();
+
+  //a single pass over all of the ADC channels, the conversions are clocked out back to back
+  AD5593R_Status status = _write_register(_ADAC_ADC_SEQUENCE, sequence_msbs, channels);
+  if (status == AD5593R_OK) status = _write_pointer(_ADAC_ADC_READ);
+
+  byte buffer[2 * 9];
+  size_t received = 0;
+  if (status == AD5593R_OK) received = _read(buffer, 2 * num_of_results);
+  _deselect();
+
+  byte channels_read = 0;
+  for (size_t i = 0; i + 1 < received; i += 2) {
+    //bits 12-15 of each result hold the channel it was converted from, 8 for the temperature
+    byte channel = buffer[i] >> 4;
+    if (channel == 8) {
+      values.temperature_code = ((buffer[i] & 0x0f) << 8) | buffer[i + 1];
+      _values_changed = 1;
+      AD5593R_LOG_TRACE(AD5593R_EVENT_ADC_READ, channel, values.temperature_code);
+      continue;
+    }
+    if (channel > 7) continue;
+    codes[channel] = _ADC_code(channel, ((buffer[i] & 0x0f) << 8) | buffer[i + 1]);
+    values.ADC_codes[channel] = codes[channel];
+    _values_changed = 1;
+    channels_read |= 1 << channel;
+    AD5593R_LOG_TRACE(AD5593R_EVENT_ADC_READ, channel, codes[channel]);
+    if (_monitor) _monitor->_ADC(channel, codes[channel]);
+  }
+  return channels_read;
 }
 
-
-void AD5593R::configure_GPI(byte channel) {
-  if (_a0 > -1) digitalWrite(_a0, LOW);
-  config.DACs[channel] = 1;
-  byte channel_byte = 1 << channel;
-  //check to see if the channel is a gpi already
-  if ((_GPI_config & channel_byte) != channel_byte) {
-    _GPI_config = _GPI_config ^ _GPI_config;
+AD5593R_Status AD5593R::start_ADC_stream(AD5593R_Sample_Buffer& buffer) {
+  AD5593R_STATS_SCOPE(AD5593R_OP_STREAM);
+  byte channels = 0;
+  for (int i = 0; i < _num_of_channels; i++) {
+    if (config.ADCs[i] == 1) channels |= 1 << i;
+  }
+  if (channels == 0 && !_temperature_in_sequence) {
+    AD5593R_LOG_ERROR(AD5593R_EVENT_NO_ADCS, 0xff, 0);
+    return AD5593R_ERROR_ROLE;
   }
-  Wire.beginTransmission(_i2c_address);
-  // write  to gpio-read register
-  Wire.write(_ADAC_GPIO_RD_CONFIG);
-  Wire.write(0x0);
-  Wire.write(_GPI_config);
-  Wire.endTransmission();
+  if (_ADC_max == -1) {
+    AD5593R_LOG_ERROR(AD5593R_EVENT_NO_VREF, 0xff, 0);
+    return AD5593R_ERROR_NO_VREF;
+  }
+  _stream_buffer = &buffer;
+  //the repeat bit makes the sequencer wrap around, so every read returns the next conversion
+  byte sequence_msbs = _ADAC_SEQUENCE_ON | (_temperature_in_sequence ? _ADAC_SEQUENCE_TEMP : 0x00);
+  _stream_sequence = (uint16_t(sequence_msbs) << 8) | channels;
+  _registers_valid &= ~(1 << _ADAC_ADC_SEQUENCE);
+
+  _select();
+  AD5593R_Status status = _arm_ADC_stream();
+  _deselect();
+  if (status != AD5593R_OK) return status;
+  AD5593R_LOG_INFO(AD5593R_EVENT_STREAM_START, 0xff, channels);
+  return AD5593R_OK;
+}
 
-  if (_a0 > -1) digitalWrite(_a0, HIGH);
-  AD5593R_PRINT("Channel ");
-  AD5593R_PRINT(channel);
-  AD5593R_PRINTLN(" is configured as a GPI");
+AD5593R_Status AD5593R::_arm_ADC_stream() {
+  //rewriting the sequence register restarts the sequence from the first channel
+  AD5593R_Status status = _update_register(_ADAC_ADC_SEQUENCE, _stream_sequence);
+  if (status == AD5593R_OK && _read_pointer != _ADAC_ADC_READ) {
+    status = _write_pointer(_ADAC_ADC_READ);
+  }
+  return status;
 }
 
-void AD5593R::configure_GPIs(bool* channels) {
-  for (size_t i = 0; i < _num_of_channels; i++) {
-    if (channels[i] == 1) {
-      configure_GPI(i);
+size_t AD5593R::poll_ADC_stream(size_t max_samples) {
+  AD5593R_STATS_SCOPE(AD5593R_OP_STREAM);
+  if (_stream_buffer == nullptr) return 0;
+  size_t space = _stream_buffer->space();
+  if (max_samples > space) max_samples = space;
+  if (max_samples == 0) return 0;
+
+  _select();
+  if (_arm_ADC_stream() != AD5593R_OK) {
+    _deselect();
+    return 0;
+  }
+  byte buffer[AD5593R_MAX_TRANSFER];
+  size_t total = 0;
+  while (total < max_samples) {
+    size_t count = max_samples - total;
+    if (count > AD5593R_MAX_TRANSFER / 2) count = AD5593R_MAX_TRANSFER / 2;
+    size_t received = _read(buffer, 2 * count) / 2;
+    for (size_t i = 0; i < received; i++) {
+      uint16_t sample = (uint16_t(buffer[2 * i]) << 8) | buffer[2 * i + 1];
+      _stream_buffer->push(sample);
+      //the temperature indicator comes back as channel 8
+      if (_monitor && sample < 0x8000) _monitor->_ADC(sample >> 12, sample & 0x0fff);
     }
+    total += received;
+    if (received < count) break;
   }
+  _deselect();
+  return total;
 }
 
+void AD5593R::stop_ADC_stream() {
+  //the chip only converts while it is being read, so there is nothing to send
+  _stream_buffer = nullptr;
+  AD5593R_LOG_INFO(AD5593R_EVENT_STREAM_STOP, 0xff, 0);
+}
 
-void AD5593R::configure_GPO(byte channel) {
-  if (_a0 > -1) digitalWrite(_a0, LOW);
-  config.DACs[channel] = 1;
-  byte channel_byte = 1 << channel;
-  //check to see if the channel is a gpo already
-  if ((_GPO_config & channel_byte) != channel_byte) {
-    _GPO_config = _GPO_config ^ _GPO_config;
-  }
-  Wire.beginTransmission(_i2c_address);
-  // write  to gpio-write register
-  Wire.write(_ADAC_GPIO_WR_CONFIG);
-  Wire.write(0x0);
-  Wire.write(_GPI_config);
-  Wire.endTransmission();
 
-  if (_a0 > -1) digitalWrite(_a0, HIGH);
-  AD5593R_PRINT("Channel ");
-  AD5593R_PRINT(channel);
-  AD5593R_PRINTLN(" is configured as a GPO");
+AD5593R_Status AD5593R::configure_GPI(byte channel) {
+  bool channels[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+  channels[channel] = 1;
+  return configure_GPIs(channels);
 }
 
-void AD5593R::configure_GPOs(bool* channels) {
-  for (size_t i = 0; i < _num_of_channels; i++) {
-    if (channels[i] == 1) {
-      configure_GPO(i);
-    }
-  }
+AD5593R_Status AD5593R::configure_GPIs(bool* channels) {
+  return _add_pins(_ADAC_GPIO_RD_CONFIG, channels, config.GPIs);
+}
+
+
+AD5593R_Status AD5593R::configure_GPO(byte channel) {
+  bool channels[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+  channels[channel] = 1;
+  return configure_GPOs(channels);
+}
+
+AD5593R_Status AD5593R::configure_GPOs(bool* channels) {
+  return _add_pins(_ADAC_GPIO_WR_CONFIG, channels, config.GPOs);
 }
 
 
@@ -440,43 +1001,76 @@ void AD5593R::configure_GPOs(bool* channels) {
 // }
 
 bool* AD5593R::read_GPIs() {
-
-  if (_a0 > -1) digitalWrite(_a0, LOW);
-  // request the data
-  Wire.beginTransmission(_i2c_address);
-  Wire.write(_ADAC_GPIO_READ);
-  Wire.endTransmission();
-
-  uint16_t data_bits = 0;
-  Wire.requestFrom(int(_i2c_address), int(2), int(1));
-  // mask bits, build the word
-  if (Wire.available()) data_bits = (Wire.read() & 0x0f) << 8;
-  if (Wire.available()) data_bits = data_bits | Wire.read();
-  if (_a0 > -1) digitalWrite(_a0, HIGH);
-
-  for (size_t i = 0; i < _num_of_channels; i++) {
+  AD5593R_STATS_SCOPE(AD5593R_OP_READ_GPIS);
+  _publish_scope publish(*this);
+  byte levels;
+  //on a failed read the last levels are kept, health().last_error tells why
+  if (read_mask(levels) != AD5593R_OK) return values.GPI_reads;
+  for (int i = 0; i < _num_of_channels; i++) {
     if (config.GPIs[i] == 1) {
-      values.GPI_reads[i] = bool(data_bits & 0x01);
+      values.GPI_reads[i] = (levels >> i) & 0x01;
     }
-    data_bits >> 1;
   }
+  _values_changed = 1;
   return values.GPI_reads;
 }
 
-void AD5593R::write_GPOs(bool* pin_states) {
-  byte data_bits = 0;
-  for (size_t i = 0; i < _num_of_channels; i++) {
+AD5593R_Status AD5593R::write_GPOs(bool* pin_states) {
+  AD5593R_STATS_SCOPE(AD5593R_OP_WRITE_GPOS);
+  _publish_scope publish(*this);
+  byte levels = 0;
+  for (int i = 0; i < _num_of_channels; i++) {
+    if (config.GPOs[i] == 1) {
+      levels |= pin_states[i] << i;
+    }
+  }
+  AD5593R_Status status = write_mask(levels);
+  if (status != AD5593R_OK) return status;
+  for (int i = 0; i < _num_of_channels; i++) {
     if (config.GPOs[i] == 1) {
       values.GPO_writes[i] = pin_states[i];
-      data_bits = data_bits & pin_states[i];
     }
-    data_bits << 1;
-  }
-  if (_a0 > -1) digitalWrite(_a0, LOW);
-  Wire.beginTransmission(_i2c_address);
-  Wire.write(_ADAC_GPIO_WR_DATA);
-  Wire.write(0x00);
-  Wire.write(data_bits);
-  Wire.endTransmission();
-  if (_a0 > -1) digitalWrite(_a0, HIGH);
-}
\ No newline at end of file
+  }
+  _values_changed = 1;
+  return AD5593R_OK;
+}
+
+AD5593R_Status AD5593R::read_mask(byte& levels) {
+  AD5593R_STATS_SCOPE(AD5593R_OP_READ_GPIS);
+  _select();
+  //the pointer only has to be sent if the last read was not a GPIO read
+  AD5593R_Status status = AD5593R_OK;
+  if (_read_pointer != _ADAC_GPIO_READ) {
+    status = _write_pointer(_ADAC_GPIO_READ);
+  }
+  byte buffer[2];
+  size_t received = 0;
+  if (status == AD5593R_OK) received = _read(buffer, 2);
+  _deselect();
+  if (status != AD5593R_OK) return status;
+  if (received < 2) return _read_error();
+  //the levels are in the LSBs, only pins configured as inputs are reported
+  levels = buffer[1] & _registers[_ADAC_GPIO_RD_CONFIG];
+  if (_monitor) _monitor->_GPIs(levels, _registers[_ADAC_GPIO_RD_CONFIG]);
+  return AD5593R_OK;
+}
+
+AD5593R_Status AD5593R::write_mask(byte levels) {
+  AD5593R_STATS_SCOPE(AD5593R_OP_WRITE_GPOS);
+  _select();
+  AD5593R_Status status = _update_register(_ADAC_GPIO_WR_DATA, levels);
+  _deselect();
+  return status;
+}
+
+AD5593R_Status AD5593R::set_mask(byte mask) {
+  return write_mask(_register(_ADAC_GPIO_WR_DATA) | mask);
+}
+
+AD5593R_Status AD5593R::clear_mask(byte mask) {
+  return write_mask(_register(_ADAC_GPIO_WR_DATA) & ~mask);
+}
+
+AD5593R_Status AD5593R::toggle_mask(byte mask) {
+  return write_mask(_register(_ADAC_GPIO_WR_DATA) ^ mask);
+}
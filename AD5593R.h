@@ -23,28 +23,35 @@ https://github.com/LukasJanavicius
 
 //////Definitions and imports//////
 
-// To enable debugging please place the following before the library import,
-// and be sure to use Serial.begin() in the setup.
-//  AD5593R_DEBUG
+// Driver events are recorded in a binary trace, see AD5593R_Trace.h. To enable it set
+// AD5593R_LOG_LEVEL with a build flag, or define AD5593R_DEBUG to also print every event
+// to Serial, and be sure to use Serial.begin() in the setup.
 #pragma once
-//comment this line to disable debugging
-#define AD5593R_DEBUG
-
-#ifdef AD5593R_DEBUG
-#define AD5593R_PRINT(...)    Serial.print(__VA_ARGS__)
-#define AD5593R_PRINTLN(...)  Serial.println(__VA_ARGS__)
-#else
-#define AD5593R_PRINT(...)
-#define AD5593R_PRINTLN(...)
-#endif
 
 #ifndef AD5593R_h
 #define AD5593R_h
 #endif
 #include <Arduino.h>
+#include "AD5593R_Transport.h"
+#include "AD5593R_Status.h"
+#include "AD5593R_Transfer.h"
+#include "AD5593R_Sample_Buffer.h"
+#include "AD5593R_Trace.h"
+#include "AD5593R_Stats.h"
+#include "AD5593R_Seqlock.h"
+#include "AD5593R_State.h"
+
+// Every call that changes values also publishes a copy of it for snapshot(), for readers on other
+// tasks or cores. This costs a second copy of values in RAM, set to 0 to leave it out
+#ifndef AD5593R_SNAPSHOT
+#define AD5593R_SNAPSHOT 1
+#endif
 
 
 //////Classes//////
+class AD5593R_Bus;
+class AD5593R_Monitor;
+
 class AD5593R {
 public:
 
@@ -52,8 +59,8 @@ public:
   // each array follows the form [channel0,...,channel7]
   // where a  1 indicates the channel should be configured as the name implies
   // for example an array ADCs[8] = {1,1,0,0,0,0,0,0} will configure channels 0 and 1 as ADCs.
-  // a declaration of this structure should be defined in your code, and passed into configure().
-  // You should not double assign pins, as only the first declaration will be assigned.
+  // a declaration of this structure should be defined in your code, and passed into configure_pins().
+  // You should not double assign pins, configure_pins() rejects such a configuration.
   struct configuration {
     bool ADCs[8]; //ADC pins
     bool DACs[8]; //DAC pins
@@ -62,91 +69,262 @@ public:
   };
   configuration config;
 
-  // This structure contains arrays of
+  // This structure contains arrays of the last values read from or written to each channel,
+  // in volts and as raw 12-bit codes
   struct Read_write_values {
     float ADCs[8];
     float DACs[8];
     bool GPI_reads[8];
     bool GPO_writes[8];
+    uint16_t ADC_codes[8];
+    uint16_t DAC_codes[8];
+    // last result of the temperature indicator, see enable_temperature(), in degrees C and as a raw code
+    float temperature;
+    uint16_t temperature_code;
   };
   Read_write_values values;
   // constructor for the class, a0 is the digital pin connected to the AD5593R
   // if no pin is specified it is assumed only one AD5593R is connected
   AD5593R(int a0 = -1);
 
+  // same as above, but all bus accesses go through the given transport instead of the global Wire object.
+  // The transport must outlive the AD5593R object, see AD5593R_Transport.h
+  AD5593R(AD5593R_Transport& transport, int a0 = -1);
+
+#ifdef ARDUINO
+  // same, on another I2C controller such as Wire1 of the ESP32, see AD5593R_wire_transport()
+  AD5593R(TwoWire& wire, int a0 = -1);
+#endif
+
+  // The reference, range and pin role calls below return AD5593R_OK, or the bus error of the register
+  // write, in which case the driver keeps its previous reference, range or roles. Between begin_update()
+  // and end_update() the write is deferred, they return AD5593R_OK and end_update() reports the write.
+
   // enables the internal reference voltage of 2.5 V
-  void enable_internal_Vref();
+  AD5593R_Status enable_internal_Vref();
 
   // disables the internal reference voltage of 2.5 V
-  void disable_internal_Vref();
+  AD5593R_Status disable_internal_Vref();
 
   // sets the maximum ADC input to 2x Vref
-  void set_ADC_max_2x_Vref();
+  AD5593R_Status set_ADC_max_2x_Vref();
 
   // sets the maximum ADC input to 1x Vref
-  void set_ADC_max_1x_Vref();
+  AD5593R_Status set_ADC_max_1x_Vref();
 
   // sets the maximum DAC output to 2x Vref
-  void set_DAC_max_2x_Vref();
+  AD5593R_Status set_DAC_max_2x_Vref();
 
   // sets the maximum DAC output to 2x Vref
-  void set_DAC_max_1x_Vref();
+  AD5593R_Status set_DAC_max_1x_Vref();
 
   // If you use an external reference voltage you should call this function. Failure to set the reference voltage,
   // or enable the internal reference will mean that any DAC/ADC function call will result in an error!
   void set_Vref(float Vref);
 
   //configures the selected channel as a DAC
-  void configure_DAC(byte channel);
-
-  void configure_DACs(bool* channels);
-  // Sets the output voltage value of a given channel, returns 1 if the write is completed
-  // if the function returns -1 if the specified channel is not an DAC,
-  // if no reference voltage is specified a -2 will be returned,
-  // and if the voltage exceeds the maximum allowable voltage a -3 will be returned.
-  int write_DAC(byte channel, float voltage);
-
-  void write_DACs(float* voltages);
+  AD5593R_Status configure_DAC(byte channel);
+
+  // configures every channel marked in channels as a DAC, with a single register write
+  AD5593R_Status configure_DACs(bool* channels);
+  // Sets the output voltage value of a given channel, returns AD5593R_OK (1) if the write is completed
+  // if the function returns AD5593R_ERROR_ROLE (-1) if the specified channel is not an DAC,
+  // if no reference voltage is specified AD5593R_ERROR_NO_VREF (-2) will be returned,
+  // and if the voltage exceeds the maximum allowable voltage AD5593R_ERROR_RANGE (-3) will be returned.
+  // A failed bus transaction returns one of the bus errors in AD5593R_Status.h
+  AD5593R_Status write_DAC(byte channel, float voltage);
+
+  // Sets every channel configured as a DAC to voltages[channel], the outputs change together.
+  // The values are staged in the input registers and loaded with a single LDAC command, all in one
+  // transaction when AD5593R_MAX_TRANSFER allows. Nothing is written if any voltage is out of range.
+  // Returns 1 on success, -1 if no channel is a DAC, and -2/-3 as write_DAC().
+  AD5593R_Status write_DACs(float* voltages);
+
+  // same as write_DACs(), with raw 12-bit codes
+  AD5593R_Status write_DAC_codes(const uint16_t* codes);
+
+  // Builds the 3 byte pointer/data frame that writes code to a DAC channel, as sent by write_DAC_code().
+  // Frames can be prepared ahead of time and sent back to back, see AD5593R_Waveform.h
+  static void encode_DAC_frame(byte channel, uint16_t code, byte* frame);
+
+  // Integer versions of write_DAC(), they never use floating point math and may be called from an ISR.
+  // write_DAC_code() takes the raw 12-bit code (0-4095) and needs no reference voltage, write_DAC_mV()
+  // takes millivolts. The return values are the same as write_DAC(), values.DAC_codes is updated.
+  AD5593R_Status write_DAC_code(byte channel, uint16_t code);
+  AD5593R_Status write_DAC_mV(byte channel, uint32_t millivolts);
 
   //configures the selected channel as a ADC
-  void configure_ADC(byte channel);
+  AD5593R_Status configure_ADC(byte channel);
 
 
-  void configure_ADCs(bool* channels);
+  AD5593R_Status configure_ADCs(bool* channels);
 
   // Reads the voltage value of a given ADC channel, returns the Voltage if the write is completed
   // if the function returns -1 if the specified channel is not an ADC,
   // and if no reference voltage is specified a -2 will be returned.
+  // A failed bus transaction returns its AD5593R_Status, it never reads as 0 V.
   float read_ADC(byte channel);
 
+  // Integer versions of read_ADC(), they never use floating point math and may be called from an ISR.
+  // read_ADC_code() returns the raw 12-bit code and needs no reference voltage, read_ADC_mV() returns millivolts.
+  // The error values are the same as read_ADC(), values.ADC_codes is updated.
+  int read_ADC_code(byte channel);
+  int32_t read_ADC_mV(byte channel);
+
+  // Conversions between millivolts and codes for the current reference and range, using the
+  // fixed-point scale factors computed whenever Vref or a 2x mode changes
+  uint16_t DAC_mV_to_code(uint32_t millivolts);
+  uint32_t ADC_code_to_mV(uint16_t code);
+
+  // Adds the internal temperature indicator to the ADC sequence, after the ADC channels. Its result comes
+  // back in the same read as the channels: read_ADC_codes() stores it in values.temperature_code,
+  // read_ADCs() also in values.temperature, and an ADC stream carries it as channel 8.
+  // A stream that is already running includes it once it is started again.
+  void enable_temperature();
+  void disable_temperature();
+
+  // Converts a temperature indicator code to millidegrees C with the data sheet equation for the current
+  // reference and ADC range, in integer math. The result is meaningless without a reference voltage.
+  int32_t temperature_code_to_mC(uint16_t code);
+
+  // Reads every channel configured as an ADC with a single sequenced conversion, the results
+  // are stored in values.ADCs which is returned. Channels that are not ADCs are left untouched.
   float* read_ADCs();
 
+  // Same single sequenced conversion as read_ADCs(), but the raw 12-bit codes are stored in codes[channel]
+  // (and values.ADC_codes). No reference voltage is needed. Returns a bit mask of the channels that were read.
+  byte read_ADC_codes(uint16_t* codes);
+
+  // Same, but only converts the ADC channels in the mask channels. Returns 0 without a transaction if
+  // one of them is not an ADC
+  byte read_ADC_codes(byte channels, uint16_t* codes);
+
+  // Starts continuous acquisition of every channel configured as an ADC. The sequence register is set
+  // once with the repeat bit, after which poll_ADC_stream() only clocks conversions out of the chip.
+  // Raw samples are pushed into buffer, which must outlive the stream.
+  // Returns 1 on success, -1 if no channel is an ADC, and -2 if no reference voltage is specified.
+  AD5593R_Status start_ADC_stream(AD5593R_Sample_Buffer& buffer);
+
+  // Reads up to max_samples conversions into the stream buffer, limited by the free space in the buffer.
+  // Returns the number of samples added. Other ADC calls may be made while streaming, the stream
+  // is set up again on the next poll.
+  size_t poll_ADC_stream(size_t max_samples = AD5593R_Sample_Buffer::capacity);
+
+  // Stops the acquisition started by start_ADC_stream(), no bus transaction is needed.
+  void stop_ADC_stream();
+
 
-  void configure_GPI(byte channel);
-  void configure_GPIs(bool* channels);
+  AD5593R_Status configure_GPI(byte channel);
+  AD5593R_Status configure_GPIs(bool* channels);
 
-  void configure_GPO(byte channel);
-  void configure_GPOs(bool* channels);
+  AD5593R_Status configure_GPO(byte channel);
+  AD5593R_Status configure_GPOs(bool* channels);
 
+  // Reads every channel configured as a GPI into values.GPI_reads, which is returned.
+  // If the read fails values.GPI_reads keeps the last levels read, see health()
   bool* read_GPIs();
-  void write_GPOs(bool* pin_states);
 
+  // Sets every channel configured as a GPO to pin_states[channel], in a single register write.
+  // values.GPO_writes is only updated when the write succeeds
+  AD5593R_Status write_GPOs(bool* pin_states);
+
+  // Bit mask versions of the GPIO calls, bit n is channel n. They do not update values.GPI_reads or
+  // values.GPO_writes. The outputs are written from the shadow of the GPIO write data register, so each
+  // call is at most one 3 byte transaction, and none if the outputs already have the requested levels.
+
+  // Reads the levels of the channels configured as GPIs into levels in one read, others read as 0.
+  // levels is only written when AD5593R_OK is returned
+  AD5593R_Status read_mask(byte& levels);
+
+  // sets the outputs to levels
+  AD5593R_Status write_mask(byte levels);
+
+  // drives the outputs in mask high, low, or to the opposite level, leaving the others as they are
+  AD5593R_Status set_mask(byte mask);
+  AD5593R_Status clear_mask(byte mask);
+  AD5593R_Status toggle_mask(byte mask);
 
 
-  /*
 
   // By passing in the configuration structure this function assigns the functionality
   // to each pin, as described in the configuration. As stated above, you should not
   // assign multiple functionalities to a single pin. In this event the function will return
-  // -1 and print an error if debug is enabled. A 1 will be returned if the configuration is successful
-  int configure_pins(*configuration config);
+  // -1 and print an error if debug is enabled. A 1 will be returned if the configuration is successful.
+  // Pins without a function are pulled down. Each configuration register is written at most once,
+  // and only if its value changes, so calling this again with the same configuration is free.
+  AD5593R_Status configure_pins(configuration* pins);
+
+  // Holds back control register writes until the matching end_update(), which sends every
+  // register that changed in a single transaction. Calls may be nested.
+  void begin_update();
+
+  // returns the status of the flush, AD5593R_OK when there was nothing to send
+  AD5593R_Status end_update();
+
+  // Returns the value of a control register as last written to the device, without a bus transaction.
+  // address is one of the control register addresses listed in the data sheet (0-15)
+  uint16_t get_register(byte address);
+
+  // Corrects every code read from an ADC channel with a 4096 entry table, the result is table[raw code].
+  // Applies to read_ADC*(), read_ADCs() and AD5593R_Filter, samples of an ADC stream stay raw.
+  // nullptr removes the correction. Tables are built with AD5593R_Calibration and must outlive their use
+  void set_ADC_table(byte channel, const uint16_t* table);
+
+  // Same for a DAC channel, every code written to it is replaced by table[code] before it is sent.
+  // Applies to write_DAC*(), AD5593R_Bus and AD5593R_Waveform, values.DAC_codes holds the requested codes
+  void set_DAC_table(byte channel, const uint16_t* table);
+
+  // Sets the retry budget of each bus transaction, the backoff before the first retry is backoff us
+  // and doubles on every further retry, see AD5593R_Status.h. retries = 0 disables retrying
+  void set_retries(byte retries, uint16_t backoff = AD5593R_RETRY_BACKOFF);
+
+  // error counters and state of the device
+  const AD5593R_Health& health() const { return _health; }
+  bool online() const { return _health.online; }
+
+  // Tries to reach the device with a single transaction, also while it is offline.
+  // Returns AD5593R_OK and brings the device back online if it answers
+  AD5593R_Status probe();
+
+  // Performs a software reset of the chip. The shadow registers, pin roles, ranges and DAC codes of
+  // the driver go back to their power-on values. A reference given with set_Vref() is kept, the
+  // internal reference is off after the reset and needs enable_internal_Vref() again
+  AD5593R_Status reset();
+
+  // Copies the control registers, DAC codes, reference and ranges into state, without a bus transaction.
+  // AD5593R_State::serialize() turns it into bytes that survive a reset of the microcontroller
+  void save_state(AD5593R_State* state) const;
+
+  // Brings the chip back to state, e.g. after a brownout or a bus fault: a software reset, then only the
+  // registers that differ from their power-on values and the DAC codes, in as few burst writes as
+  // AD5593R_MAX_TRANSFER allows. The reference and ranges go first and the DAC codes before the pin
+  // roles, so the outputs come up at their levels. With verify every restored register and DAC code
+  // is read back, AD5593R_ERROR_VERIFY is returned on a mismatch
+  AD5593R_Status restore_state(const AD5593R_State& state, bool verify = false);
+
+#if AD5593R_SNAPSHOT
+  // Copies values as they were when the last call that changed them returned, from any task or core.
+  // The copy is always a complete one, and neither the device calls nor other readers wait for it.
+  // Returns the version of the copy (it grows with every published change), 0 if the copy could not
+  // be taken because the values kept changing, see AD5593R_Seqlock.h
+  uint32_t snapshot(Read_write_values* copy) const { return _published.read(*copy); }
+
+  // version of the values last published, to tell whether a new snapshot is worth taking
+  uint32_t values_version() const { return _published.version(); }
+#endif
+
+#ifdef AD5593R_STATS
+  // Copies the performance counters of this device into snapshot, see AD5593R_Stats.h
+  void get_stats(AD5593R_Stats* snapshot);
+
+  void reset_stats();
+#endif
+
+  /*
 
   //call this function in
   void update(DAC_Writes[8],ADC_Reads[8]);
 
-  // performs a software reset, generally a good idea to call in the setup
-  void reset();
-
 
   // Reads the set value of a given DAC channel, -1 will be returned if
   float read_DAC(int channel);
@@ -160,6 +338,13 @@ public:
   void power_down(int channel = -1);
   */
 private:
+  friend class AD5593R_Bus;
+  friend class AD5593R_Capture;
+  friend struct AD5593R_Calibration;
+  friend class AD5593R_Filter;
+  friend class AD5593R_Monitor;
+  friend class AD5593R_Waveform;
+
   // checks if the given channel is configured as an ADC
   // returns 1 if the channel is configured, 0 if the channel is not
   bool is_ADC(int channel);
@@ -173,22 +358,149 @@ private:
   // https://github.com/MikroElektronika/HEXIWEAR/blob/master/SW/Click%20Examples%20mikroC/examples/ADAC/library/__ADAC_Driver.h
 
 
+  // pulls a0 LOW so the device answers on _i2c_address, nothing is sent if it already is
+  void _select();
+
+  // releases a0 again
+  void _deselect();
+
+  // writes a pointer byte followed by two data bytes
+  AD5593R_Status _write_register(byte pointer, byte msbs, byte lsbs);
+
+  // writes a lone pointer byte, used to set up the following read
+  AD5593R_Status _write_pointer(byte pointer);
+
+  // Reads length bytes from the device, returns the number of bytes received.
+  // On a short read _health.last_error tells why
+  size_t _read(byte* data, size_t length);
+
+  // writes any number of 3 byte pointer/data frames, as few transactions as AD5593R_MAX_TRANSFER allows,
+  // returns the status of the last failed transaction
+  AD5593R_Status _write_frames(const byte* data, size_t length);
+
+  // a single write transaction, retried within the retry budget
+  AD5593R_Status _write(const byte* data, size_t length);
+
+  // whether an offline device is due for another attempt, always 1 while online
+  bool _may_transact();
+
+  // number of attempts a transaction gets
+  byte _attempts() { return _health.online ? _retries + 1 : 1; }
+
+  // updates the health after a transaction, returns status
+  AD5593R_Status _completed(AD5593R_Status status);
+
+  // puts the shadow and the driver state back to the power-on values of the chip
+  void _reset_shadow();
+
+  // reads back a control register or a DAC input register with pointer, returns 1 if it holds value
+  bool _verify(byte pointer, uint16_t value);
+
+  // why the last _read() came back short
+  AD5593R_Status _read_error() const { return _health.online ? _health.last_error : AD5593R_ERROR_OFFLINE; }
+
+  // recomputes the maximum voltages and the scale factors after Vref or a 2x mode changes
+  void _update_scales();
+
+  // sets a control register in the shadow, it is written on the next flush unless it already holds value.
+  // The flush happens right away unless begin_update() is in effect. A failed write leaves the
+  // confirmed value in _registers, so the next update builds on what the device holds
+  AD5593R_Status _update_register(byte address, uint16_t value);
+
+  // the value the next update of a register builds on, the pending one while it is dirty
+  uint16_t _register(byte address) const {
+    return (_registers_dirty & (1 << address)) ? _pending[address] : _registers[address];
+  }
+
+  // writes every dirty control register in a single transaction
+  AD5593R_Status _flush_registers();
+
+  // sets the given channels in the pin configuration register at address and, once written, marks them in roles
+  AD5593R_Status _add_pins(byte address, bool* channels, bool* roles);
+
+  // the code sent for a DAC code after calibration
+  uint16_t _DAC_code(byte channel, uint16_t code) {
+    return _DAC_tables[channel] != nullptr ? _DAC_tables[channel][code] : code;
+  }
+
+  // an ADC result after calibration
+  uint16_t _ADC_code(byte channel, uint16_t code) {
+    return _ADC_tables[channel] != nullptr ? _ADC_tables[channel][code] : code;
+  }
+
+  // restores the stream sequence and the ADC read pointer if another call changed them
+  AD5593R_Status _arm_ADC_stream();
+
   int _num_of_channels = 8;
 
   int _a0;
+  // a0 is held LOW, only tracked for a device without a bus manager
+  bool _a0_low = 0;
+
+  AD5593R_Transport* _transport;
+
+  // bus manager the device was added to, if any, see AD5593R_Bus.h
+  AD5593R_Bus* _bus = nullptr;
+
+  // last pointer byte written to the device, _ADAC_NULL after a register write
+  byte _read_pointer = 0;
+
+  // ADC streaming state, see start_ADC_stream()
+  AD5593R_Sample_Buffer* _stream_buffer = nullptr;
+  uint16_t _stream_sequence = 0;
+
+  // shadow of the 16 control registers, bit n of _registers_valid is set
+  // once register n is known to hold the value in _registers[n], and bit n of
+  // _registers_dirty while _pending[n] still has to be written
+  uint16_t _registers[16];
+  uint16_t _pending[16];
+  uint16_t _registers_valid;
+  uint16_t _registers_dirty;
+
+  // calibration tables, see set_ADC_table()
+  const uint16_t* _ADC_tables[8];
+  const uint16_t* _DAC_tables[8];
+
+  // threshold and edge checks of every read, see AD5593R_Monitor.h
+  AD5593R_Monitor* _monitor = nullptr;
+
+  // Publishes values for snapshot() when the outermost call that changed them returns,
+  // so readers never see the values of a call half done. A call that changed nothing, such as
+  // one that failed, publishes nothing and leaves values_version() as it was
+  struct _publish_scope {
+    AD5593R& device;
+    _publish_scope(AD5593R& owner) : device(owner) { device._publish_depth++; }
+    ~_publish_scope() {
+      if (--device._publish_depth == 0 && device._values_changed) device._publish();
+    }
+  };
+  void _publish() {
+    _values_changed = 0;
+#if AD5593R_SNAPSHOT
+    _published.write(values);
+#endif
+  }
+  byte _publish_depth = 0;
+  // set wherever values is written, cleared once it is published
+  bool _values_changed = 0;
+#if AD5593R_SNAPSHOT
+  AD5593R_Seqlock<Read_write_values> _published;
+#endif
 
-  //general purpose control register data Bytes
-  byte _GPRC_msbs;
-  byte _GPRC_lsbs;
+  // nesting depth of begin_update()
+  byte _update_depth = 0;
 
-  // power control register data bytes;
-  byte _PCR_msbs;
-  byte _PCR_lsbs;
+  // retry budget and health, see AD5593R_Status.h
+  byte _retries = AD5593R_RETRIES;
+  uint16_t _backoff = AD5593R_RETRY_BACKOFF;
+  AD5593R_Health _health;
 
-  byte _DAC_config;
-  byte _ADC_config;
-  byte _GPI_config;
-  byte _GPO_config;
+#ifdef AD5593R_STATS
+  AD5593R_Stats _stats;
+
+  // operation whose calls and transactions are being counted, see AD5593R_Stats_Scope
+  byte _stats_operation = AD5593R_OP_OTHER;
+#endif
 
   //default address of the AD5593R, multiple devices are handled by setting the desired device's a0 to LOW
   //by default the a0 pin will be pulled high, effectively changing its address. For more information on the addressing please
@@ -207,4 +519,17 @@ private:
   float _ADC_max = -1;
 
   float _DAC_max = -1;
+
+  // scale factors, see _update_scales()
+  uint32_t _ADC_max_mV = 0;
+  uint32_t _DAC_max_mV = 0;
+  uint32_t _ADC_mV_per_code = 0;   // millivolts per code, 16 fractional bits
+  uint32_t _DAC_codes_per_mV = 0;  // codes per millivolt, 16 fractional bits
+  float _ADC_volts_per_code = 0;
+  float _DAC_codes_per_volt = 0;
+
+  // temperature indicator conversion, see _update_scales()
+  bool _temperature_in_sequence = 0;
+  int32_t _temperature_zero = 0;         // code at 25 degrees C, 4 fractional bits
+  int32_t _temperature_mC_per_code = 0;  // 16 fractional bits
 };
@@ -0,0 +1,143 @@
+#include "AD5593R_Acquisition.h"
+
+#if AD5593R_HAS_TASKS
+
+AD5593R_Acquisition::AD5593R_Acquisition() {
+}
+
+AD5593R_Acquisition::~AD5593R_Acquisition() {
+  end();
+}
+
+int AD5593R_Acquisition::add_bus(AD5593R_Bus& bus, int core) {
+  if (_running || _num_of_buses == AD5593R_ACQUISITION_BUSES) return -1;
+  _worker& worker = _workers[_num_of_buses];
+  worker.owner = this;
+  worker.bus = &bus;
+  worker.core = core;
+  return _num_of_buses++;
+}
+
+bool AD5593R_Acquisition::begin(uint32_t period) {
+  if (_running || period == 0) return 0;
+  _period = period;
+  _records = 0;
+  __atomic_store_n(&_stopping, 0, __ATOMIC_RELEASE);
+  //the first tick leaves the workers a period to start, so they all make it
+  _start = uint32_t(micros()) + period;
+  for (byte i = 0; i < _num_of_buses; i++) {
+    _worker& worker = _workers[i];
+    worker.head = 0;
+    worker.tail = 0;
+    worker.scans_done = 0;
+    worker.missed = 0;
+    worker.dropped = 0;
+    if (!worker.task.start(_run, &worker, worker.core, "AD5593R_Acquisition")) {
+      _running = 1;
+      end();
+      return 0;
+    }
+  }
+  _running = 1;
+  return 1;
+}
+
+void AD5593R_Acquisition::end() {
+  if (!_running) return;
+  __atomic_store_n(&_stopping, 1, __ATOMIC_RELEASE);
+  for (byte i = 0; i < _num_of_buses; i++) {
+    _workers[i].task.join();
+  }
+  for (byte i = 0; i < _num_of_buses; i++) {
+    _workers[i].bus->release();
+  }
+  _running = 0;
+}
+
+void AD5593R_Acquisition::_run(void* context) {
+  _worker& worker = *static_cast<_worker*>(context);
+  AD5593R_Acquisition& owner = *worker.owner;
+  uint32_t tick = 0;
+  while (!__atomic_load_n(&owner._stopping, __ATOMIC_ACQUIRE)) {
+    uint32_t deadline = owner._start + tick * owner._period;
+    int32_t wait = int32_t(deadline - uint32_t(micros()));
+    if (wait > 0) {
+      //long waits give the core away, the last stretch is waited out exactly
+      if (wait > 2000) delay((wait - 1000) / 1000);
+      else delayMicroseconds(wait);
+      continue;
+    }
+    //ticks that have already passed are skipped, the grid stays where it was
+    uint32_t late = uint32_t(-wait);
+    if (late >= owner._period) {
+      uint32_t missed = late / owner._period;
+      __atomic_add_fetch(&worker.missed, missed, __ATOMIC_RELAXED);
+      tick += missed;
+    }
+
+    uint32_t head = worker.head;
+    if (head - __atomic_load_n(&worker.tail, __ATOMIC_ACQUIRE) == AD5593R_ACQUISITION_DEPTH) {
+      __atomic_add_fetch(&worker.dropped, 1, __ATOMIC_RELAXED);
+      tick++;
+      continue;
+    }
+    _scan& scan = worker.scans[head & (AD5593R_ACQUISITION_DEPTH - 1)];
+    scan.tick = tick;
+    scan.start = uint32_t(micros());
+    scan.num_of_frames = worker.bus->scan_all(scan.frames);
+    __atomic_add_fetch(&worker.scans_done, 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&worker.head, head + 1, __ATOMIC_RELEASE);
+    tick++;
+  }
+}
+
+bool AD5593R_Acquisition::read(AD5593R_Acquisition_Record& record) {
+  if (_num_of_buses == 0) return 0;
+  //a tick is complete once every bus has a scan at or past it
+  bool first = 1;
+  uint32_t tick = 0;
+  for (byte i = 0; i < _num_of_buses; i++) {
+    _worker& worker = _workers[i];
+    if (__atomic_load_n(&worker.head, __ATOMIC_ACQUIRE) == worker.tail) return 0;
+    uint32_t oldest = worker.scans[worker.tail & (AD5593R_ACQUISITION_DEPTH - 1)].tick;
+    if (first || int32_t(oldest - tick) < 0) tick = oldest;
+    first = 0;
+  }
+
+  record.tick = tick;
+  record.time = _start + tick * _period;
+  record.buses = 0;
+  record.num_of_frames = 0;
+  uint32_t earliest = 0;
+  uint32_t latest = 0;
+  for (byte i = 0; i < _num_of_buses; i++) {
+    _worker& worker = _workers[i];
+    const _scan& scan = worker.scans[worker.tail & (AD5593R_ACQUISITION_DEPTH - 1)];
+    if (scan.tick != tick) continue;
+    for (byte j = 0; j < scan.num_of_frames; j++) {
+      AD5593R_Acquisition_Frame& frame = record.frames[record.num_of_frames++];
+      frame.bus = i;
+      frame.frame = scan.frames[j];
+    }
+    uint32_t offset = scan.start - record.time;
+    if (record.buses == 0 || offset < earliest) earliest = offset;
+    if (record.buses == 0 || offset > latest) latest = offset;
+    record.buses |= 1 << i;
+    __atomic_store_n(&worker.tail, worker.tail + 1, __ATOMIC_RELEASE);
+  }
+  record.skew = latest - earliest;
+  _records++;
+  return 1;
+}
+
+void AD5593R_Acquisition::get_stats(AD5593R_Acquisition_Stats* stats) const {
+  for (byte i = 0; i < AD5593R_ACQUISITION_BUSES; i++) {
+    bool used = i < _num_of_buses;
+    stats->scans[i] = used ? __atomic_load_n(&_workers[i].scans_done, __ATOMIC_RELAXED) : 0;
+    stats->missed[i] = used ? __atomic_load_n(&_workers[i].missed, __ATOMIC_RELAXED) : 0;
+    stats->dropped[i] = used ? __atomic_load_n(&_workers[i].dropped, __ATOMIC_RELAXED) : 0;
+  }
+  stats->records = _records;
+}
+
+#endif
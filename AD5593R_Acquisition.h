@@ -0,0 +1,114 @@
+/*
+Parallel acquisition across several I2C buses.
+
+Each AD5593R_Bus added gets a worker task of its own (a FreeRTOS task pinned to a core on the ESP32,
+a std::thread in the host build) that scans all of its devices with scan_all() once per period.
+The buses work at the same time, so the scans per second of the whole system grow with the number
+of buses, e.g. Wire and Wire1 on the two cores of an ESP32.
+
+Every worker follows the same grid of ticks, start + n * period, and tags its scans with the tick
+number. read() merges the scans of one tick from every bus into a single record, so the output is
+time aligned whatever order the workers finish in. A worker that falls a whole period behind skips
+the ticks it missed, and a record then only holds the buses that made it.
+
+Once begin() has been called the buses and their devices belong to the workers: do not call them
+directly until end() has returned. Only available where AD5593R_HAS_TASKS is set, see AD5593R_Task.h.
+*/
+#pragma once
+#include <Arduino.h>
+#include "AD5593R.h"
+#include "AD5593R_Bus.h"
+#include "AD5593R_Task.h"
+
+#if AD5593R_HAS_TASKS
+
+#ifndef AD5593R_ACQUISITION_BUSES
+#define AD5593R_ACQUISITION_BUSES 2
+#endif
+
+// scans buffered per bus until read() merges them, a power of two
+#ifndef AD5593R_ACQUISITION_DEPTH
+#define AD5593R_ACQUISITION_DEPTH 8
+#endif
+
+struct AD5593R_Acquisition_Frame {
+  byte bus;             // index of the bus, in the order it was added
+  AD5593R_Frame frame;  // device index within the bus, channels and codes
+};
+
+// one tick of every bus
+struct AD5593R_Acquisition_Record {
+  uint32_t tick;        // number of the period since begin()
+  uint32_t time;        // micros() the tick was scheduled for
+  uint32_t skew;        // us between the first and the last bus starting its scan
+  byte buses;           // bit mask of the buses in the record
+  byte num_of_frames;
+  AD5593R_Acquisition_Frame frames[AD5593R_ACQUISITION_BUSES * AD5593R_BUS_MAX_DEVICES];
+};
+
+struct AD5593R_Acquisition_Stats {
+  unsigned long scans[AD5593R_ACQUISITION_BUSES];
+  unsigned long missed[AD5593R_ACQUISITION_BUSES];    // ticks skipped because the bus fell behind
+  unsigned long dropped[AD5593R_ACQUISITION_BUSES];   // scans lost because read() was not called in time
+  unsigned long records;
+};
+
+class AD5593R_Acquisition {
+public:
+  AD5593R_Acquisition();
+
+  // stops the workers, see end()
+  ~AD5593R_Acquisition();
+
+  // Adds a bus, its worker is pinned to core unless core is -1. Returns the index of the bus,
+  // or -1 if AD5593R_ACQUISITION_BUSES are in use or the workers are running
+  int add_bus(AD5593R_Bus& bus, int core = -1);
+
+  // starts a worker per bus, scanning every period us. Returns 0 if period is 0 or a task could not be started
+  bool begin(uint32_t period);
+
+  // stops the workers, scans that were not read are dropped
+  void end();
+
+  // Takes the oldest complete tick into record, returns 0 if no tick has been scanned by every bus yet
+  bool read(AD5593R_Acquisition_Record& record);
+
+  void get_stats(AD5593R_Acquisition_Stats* stats) const;
+
+private:
+  static_assert((AD5593R_ACQUISITION_DEPTH & (AD5593R_ACQUISITION_DEPTH - 1)) == 0,
+                "AD5593R_ACQUISITION_DEPTH must be a power of two");
+
+  struct _scan {
+    uint32_t tick;
+    uint32_t start;     // micros() when the scan started
+    byte num_of_frames;
+    AD5593R_Frame frames[AD5593R_BUS_MAX_DEVICES];
+  };
+
+  // single producer (the worker), single consumer (read()) ring of scans
+  struct _worker {
+    AD5593R_Acquisition* owner;
+    AD5593R_Bus* bus;
+    int core;
+    AD5593R_Task task;
+    _scan scans[AD5593R_ACQUISITION_DEPTH];
+    uint32_t head;      // scans written, only the worker writes it
+    uint32_t tail;      // scans taken, only read() writes it
+    unsigned long scans_done;
+    unsigned long missed;
+    unsigned long dropped;
+  };
+
+  static void _run(void* worker);
+
+  _worker _workers[AD5593R_ACQUISITION_BUSES];
+  byte _num_of_buses = 0;
+  bool _running = 0;
+  bool _stopping = 0;
+  uint32_t _period = 0;
+  uint32_t _start = 0;
+  unsigned long _records = 0;
+};
+
+#endif
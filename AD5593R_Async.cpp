@@ -0,0 +1,131 @@
+#include "AD5593R_Async.h"
+
+#if AD5593R_HAS_TASKS
+
+AD5593R_Async::AD5593R_Async(AD5593R& device) : _device(device) {
+}
+
+AD5593R_Async::~AD5593R_Async() {
+  end();
+}
+
+bool AD5593R_Async::begin(int core) {
+  __atomic_store_n(&_stopping, 0, __ATOMIC_RELEASE);
+  return _task.start(_run, this, core, "AD5593R_Async");
+}
+
+void AD5593R_Async::end() {
+  if (!_task.running()) return;
+  __atomic_store_n(&_stopping, 1, __ATOMIC_RELEASE);
+  _task.notify();
+  _task.join();
+}
+
+bool AD5593R_Async::_submit(_request& request) {
+  if (!_queue.push(request)) return 0;
+  __atomic_add_fetch(&_submitted, 1, __ATOMIC_RELEASE);
+  _task.notify();
+  return 1;
+}
+
+bool AD5593R_Async::write_DAC_code(byte channel, uint16_t code, callback done, void* context) {
+  _request request;
+  request.type = DAC_WRITE;
+  request.channel = channel;
+  request.codes[0] = code;
+  request.done = done;
+  request.context = context;
+  return _submit(request);
+}
+
+bool AD5593R_Async::write_DAC_codes(const uint16_t* codes, callback done, void* context) {
+  _request request;
+  request.type = DAC_WRITES;
+  request.channel = 0;
+  for (int i = 0; i < 8; i++) {
+    request.codes[i] = codes[i];
+  }
+  request.done = done;
+  request.context = context;
+  return _submit(request);
+}
+
+bool AD5593R_Async::read_ADC_codes(callback done, void* context) {
+  _request request;
+  request.type = ADC_SCAN;
+  request.channel = 0;
+  request.done = done;
+  request.context = context;
+  return _submit(request);
+}
+
+bool AD5593R_Async::read_GPIs(callback done, void* context) {
+  _request request;
+  request.type = GPIO_READ;
+  request.channel = 0;
+  request.done = done;
+  request.context = context;
+  return _submit(request);
+}
+
+size_t AD5593R_Async::pending() const {
+  return __atomic_load_n(&_submitted, __ATOMIC_ACQUIRE) - __atomic_load_n(&_completed, __ATOMIC_ACQUIRE);
+}
+
+void AD5593R_Async::wait_idle() {
+  while (pending() > 0) {
+    delay(1);
+  }
+}
+
+void AD5593R_Async::_execute(const _request& request) {
+  AD5593R_Async_Result result;
+  result.type = request.type;
+  result.channels = 0;
+  switch (request.type) {
+    case DAC_WRITE:
+      result.status = _device.write_DAC_code(request.channel, request.codes[0]);
+      break;
+    case DAC_WRITES:
+      result.status = _device.write_DAC_codes(request.codes);
+      break;
+    case ADC_SCAN: {
+      byte ADCs = 0;
+      for (byte i = 0; i < 8; i++) {
+        if (_device.config.ADCs[i]) ADCs |= 1 << i;
+      }
+      result.channels = _device.read_ADC_codes(ADCs, result.codes);
+      //a scan is only complete with every ADC channel in it, the health of the device tells what failed
+      if (ADCs == 0) result.status = AD5593R_ERROR_ROLE;
+      else if (result.channels == ADCs) result.status = AD5593R_OK;
+      else result.status = _device.online() ? _device.health().last_error : AD5593R_ERROR_OFFLINE;
+      break;
+    }
+    case GPIO_READ: {
+      byte levels = 0;
+      result.status = _device.read_mask(levels);
+      result.channels = levels;
+      break;
+    }
+    default:
+      result.status = AD5593R_ERROR_ROLE;
+      break;
+  }
+  if (request.done != nullptr) request.done(result, request.context);
+}
+
+void AD5593R_Async::_run(void* self) {
+  AD5593R_Async& async = *static_cast<AD5593R_Async*>(self);
+  _request request;
+  for (;;) {
+    if (async._queue.pop(request)) {
+      async._execute(request);
+      __atomic_add_fetch(&async._completed, 1, __ATOMIC_RELEASE);
+      continue;
+    }
+    if (__atomic_load_n(&async._stopping, __ATOMIC_ACQUIRE)) return;
+    async._task.wait(100);
+  }
+}
+
+#endif
@@ -0,0 +1,89 @@
+/*
+Asynchronous front end for an AD5593R.
+
+Calls on AD5593R_Async only place a typed request in a bounded lock-free queue and return at once.
+A worker task (a FreeRTOS task on the ESP32, a std::thread in the host build) executes the requests
+against the device in order and reports each one through an optional callback, which runs on the
+worker task. Once begin() has been called the device belongs to the worker: do not call it
+directly until end() has returned.
+
+Only available where AD5593R_HAS_TASKS is set, see AD5593R_Task.h.
+*/
+#pragma once
+#include <Arduino.h>
+#include "AD5593R.h"
+#include "AD5593R_Queue.h"
+#include "AD5593R_Task.h"
+
+#if AD5593R_HAS_TASKS
+
+#ifndef AD5593R_ASYNC_QUEUE_SIZE
+#define AD5593R_ASYNC_QUEUE_SIZE 16
+#endif
+
+// outcome of an asynchronous request, passed to its callback
+struct AD5593R_Async_Result {
+  byte type;          // one of AD5593R_Async::request_type
+  int status;         // AD5593R_Status of the call, an ADC scan that misses a channel reports the bus error
+  byte channels;      // ADC scan: bit mask of the channels in codes, GPIO read: input levels
+  uint16_t codes[8];  // ADC scan: raw 12-bit codes indexed by channel
+};
+
+class AD5593R_Async {
+public:
+  typedef void (*callback)(const AD5593R_Async_Result& result, void* context);
+
+  enum request_type {
+    DAC_WRITE,   // write_DAC_code()
+    DAC_WRITES,  // write_DAC_codes()
+    ADC_SCAN,    // read_ADC_codes()
+    GPIO_READ    // read_mask()
+  };
+
+  AD5593R_Async(AD5593R& device);
+
+  // stops the worker, see end()
+  ~AD5593R_Async();
+
+  // starts the worker task, pinned to core unless core is -1. Returns 0 if the task could not be started.
+  bool begin(int core = -1);
+
+  // executes the requests still queued, then stops the worker
+  void end();
+
+  // Each of these queues a request and returns at once. They return 0 if the queue is full.
+  bool write_DAC_code(byte channel, uint16_t code, callback done = nullptr, void* context = nullptr);
+  bool write_DAC_codes(const uint16_t* codes, callback done = nullptr, void* context = nullptr);
+  bool read_ADC_codes(callback done = nullptr, void* context = nullptr);
+  bool read_GPIs(callback done = nullptr, void* context = nullptr);
+
+  // number of requests queued or being executed
+  size_t pending() const;
+
+  // blocks until every request queued so far has completed
+  void wait_idle();
+
+private:
+  struct _request {
+    byte type;
+    byte channel;
+    uint16_t codes[8];
+    callback done;
+    void* context;
+  };
+
+  bool _submit(_request& request);
+  void _execute(const _request& request);
+  static void _run(void* self);
+
+  AD5593R& _device;
+  AD5593R_Task _task;
+  AD5593R_Queue<_request, AD5593R_ASYNC_QUEUE_SIZE> _queue;
+  bool _stopping = 0;
+
+  // counters of requests accepted and finished, pending() is their difference
+  size_t _submitted = 0;
+  size_t _completed = 0;
+};
+
+#endif
@@ -0,0 +1,88 @@
+#include "AD5593R_Bus.h"
+
+AD5593R_Bus::AD5593R_Bus(AD5593R_Transport& transport) : _transport(transport) {
+}
+
+int AD5593R_Bus::add(AD5593R& device) {
+  if (_num_of_devices >= AD5593R_BUS_MAX_DEVICES) return -1;
+  if (device._transport != &_transport || device._bus != nullptr) return -1;
+  //the device constructor left its a0 pin HIGH, so it is not selected yet
+  device._bus = this;
+  _devices[_num_of_devices] = &device;
+  _transport.begin();
+  return _num_of_devices++;
+}
+
+void AD5593R_Bus::_activate(AD5593R* device) {
+  if (_active == device) return;
+  if (_active != nullptr) _transport.set_a0(_active->_a0, HIGH);
+  _transport.set_a0(device->_a0, LOW);
+  _active = device;
+}
+
+void AD5593R_Bus::release() {
+  if (_active == nullptr) return;
+  _transport.set_a0(_active->_a0, HIGH);
+  _active = nullptr;
+}
+
+bool AD5593R_Bus::queue_DAC_code(byte device, byte channel, uint16_t code) {
+  if (_queue_length >= AD5593R_BUS_QUEUE_SIZE) return 0;
+  if (device >= _num_of_devices || channel > 7 || code > 4095) return 0;
+  _operation& operation = _queue[_queue_length++];
+  operation.device = device;
+  operation.channel = channel;
+  operation.code = code;
+  return 1;
+}
+
+size_t AD5593R_Bus::execute() {
+  size_t sent = 0;
+  byte frames[3 * AD5593R_BUS_QUEUE_SIZE];
+
+  //start with the device that is already selected, to save switching a0
+  int start = 0;
+  for (int i = 0; i < _num_of_devices; i++) {
+    if (_devices[i] == _active) start = i;
+  }
+  for (int offset = 0; offset < _num_of_devices; offset++) {
+    int index = (start + offset) % _num_of_devices;
+    AD5593R& device = *_devices[index];
+
+    size_t length = 0;
+    for (size_t i = 0; i < _queue_length; i++) {
+      const _operation& operation = _queue[i];
+      if (operation.device != index || device.config.DACs[operation.channel] == 0) continue;
+      AD5593R::encode_DAC_frame(operation.channel, device._DAC_code(operation.channel, operation.code), frames + length);
+      length += 3;
+    }
+    if (length == 0) continue;
+#ifdef AD5593R_STATS
+    AD5593R_Stats_Scope stats_scope(device._stats, device._stats_operation, AD5593R_OP_WRITE_DACS);
+#endif
+    AD5593R::_publish_scope publish(device);
+    _activate(&device);
+    //the values only follow a write the device took, a failed one is left out of the count
+    if (device._write_frames(frames, length) != AD5593R_OK) continue;
+    for (size_t i = 0; i < _queue_length; i++) {
+      const _operation& operation = _queue[i];
+      if (operation.device != index || device.config.DACs[operation.channel] == 0) continue;
+      device.values.DAC_codes[operation.channel] = operation.code;
+    }
+    device._values_changed = 1;
+    sent += length / 3;
+  }
+  _queue_length = 0;
+  return sent;
+}
+
+size_t AD5593R_Bus::scan_all(AD5593R_Frame* frames) {
+  size_t num_of_frames = 0;
+  for (int i = 0; i < _num_of_devices; i++) {
+    AD5593R_Frame& frame = frames[num_of_frames];
+    frame.device = i;
+    frame.channels = _devices[i]->read_ADC_codes(frame.codes);
+    if (frame.channels != 0) num_of_frames++;
+  }
+  return num_of_frames;
+}
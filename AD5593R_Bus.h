@@ -0,0 +1,80 @@
+/*
+Bus manager for several AD5593Rs sharing one I2C bus.
+
+All devices answer on the same address while their a0 pin is LOW (see AD5593R.h), so only one
+device may be selected at a time. Without a bus manager every transaction pulls a0 LOW and
+releases it again. Once a device is added to an AD5593R_Bus, its a0 pin is only switched when
+a different device needs the bus, and the bus can batch work across the whole chip array:
+queued DAC writes are grouped per device, and scan_all() reads the ADCs of every device in one pass.
+
+The devices must be constructed on the transport given to the bus.
+*/
+#pragma once
+#include <Arduino.h>
+#include "AD5593R.h"
+
+#ifndef AD5593R_BUS_MAX_DEVICES
+#define AD5593R_BUS_MAX_DEVICES 8
+#endif
+
+#ifndef AD5593R_BUS_QUEUE_SIZE
+#define AD5593R_BUS_QUEUE_SIZE 32
+#endif
+
+// ADC results of one device, filled by AD5593R_Bus::scan_all()
+struct AD5593R_Frame {
+  byte device;        // index of the device in the bus, in the order it was added
+  byte channels;      // bit mask of the channels present in codes
+  uint16_t codes[8];  // raw 12-bit codes, indexed by channel
+};
+
+class AD5593R_Bus {
+public:
+  AD5593R_Bus(AD5593R_Transport& transport);
+
+  // Adds a device to the bus and returns its index. -1 is returned if the bus is full,
+  // the device uses another transport, or it already belongs to a bus.
+  int add(AD5593R& device);
+
+  int num_of_devices() const { return _num_of_devices; }
+  AD5593R& device(byte index) { return *_devices[index]; }
+
+  // Queues a raw 12-bit DAC write, nothing is sent until execute().
+  // Returns 0 if the queue is full or device is not a valid index.
+  bool queue_DAC_code(byte device, byte channel, uint16_t code);
+
+  // Sends every queued operation. The operations are grouped per device, so each device is selected once
+  // and its DAC writes go out in as few transactions as AD5593R_MAX_TRANSFER allows, one for up to 10 writes
+  // by default (one per write with AD5593R_BURST_WRITES 0). Writes to channels that are not DACs are dropped.
+  // Returns the number of operations the devices took. When the write to a device fails its operations are
+  // not counted, its values.DAC_codes are left as they were and its health() tells why.
+  size_t execute();
+
+  // Reads every ADC channel of every device, with a single sequenced conversion per device.
+  // frames must have room for num_of_devices() entries. Devices without ADC channels are skipped.
+  // Returns the number of frames filled.
+  size_t scan_all(AD5593R_Frame* frames);
+
+  // releases the a0 pin of the device that is currently selected
+  void release();
+
+private:
+  friend class AD5593R;
+
+  // selects device, switching a0 pins only if another device was selected
+  void _activate(AD5593R* device);
+
+  struct _operation {
+    byte device;
+    byte channel;
+    uint16_t code;
+  };
+
+  AD5593R_Transport& _transport;
+  AD5593R* _devices[AD5593R_BUS_MAX_DEVICES];
+  int _num_of_devices = 0;
+  AD5593R* _active = nullptr;
+
+  _operation _queue[AD5593R_BUS_QUEUE_SIZE];
+  size_t _queue_length = 0;
+};
@@ -0,0 +1,96 @@
+#include "AD5593R_Calibration.h"
+#include <math.h>
+
+AD5593R_Calibration AD5593R_Calibration::identity() {
+  AD5593R_Calibration calibration = {65536, 0, nullptr, 0};
+  return calibration;
+}
+
+AD5593R_Calibration AD5593R_Calibration::from_gain_offset(float gain, float offset) {
+  AD5593R_Calibration calibration = {int32_t(lroundf(gain * 65536)), int32_t(lroundf(offset * 65536)), nullptr, 0};
+  return calibration;
+}
+
+uint16_t AD5593R_Calibration::apply(uint16_t code) const {
+  int32_t value = int32_t((int64_t(code) * gain + offset + 32768) >> 16);
+
+  if (points != nullptr && num_of_points >= 2) {
+    //the segment holding value, or the first/last one when value is outside the points
+    byte segment = 0;
+    while (segment + 2 < num_of_points && value > int32_t(points[2 * (segment + 1)])) {
+      segment++;
+    }
+    int32_t x0 = points[2 * segment];
+    int32_t y0 = points[2 * segment + 1];
+    int32_t x1 = points[2 * segment + 2];
+    int32_t y1 = points[2 * segment + 3];
+    if (x1 != x0) {
+      int32_t numerator = (value - x0) * (y1 - y0);
+      int32_t denominator = x1 - x0;
+      //round to nearest for either sign of the numerator
+      value = y0 + (numerator >= 0 ? numerator + denominator / 2 : numerator - denominator / 2) / denominator;
+    }
+  }
+  if (value < 0) return 0;
+  if (value > 4095) return 4095;
+  return value;
+}
+
+void AD5593R_Calibration::build_table(uint16_t* table) const {
+  for (uint16_t code = 0; code < AD5593R_CALIBRATION_TABLE_SIZE; code++) {
+    table[code] = apply(code);
+  }
+}
+
+AD5593R_Status AD5593R_Calibration::measure_loopback(AD5593R& device, byte DAC_channel, byte ADC_channel,
+                                          AD5593R_Calibration* DAC_calibration, size_t samples) {
+  if (DAC_channel > 7 || device.config.DACs[DAC_channel] == 0) {
+    AD5593R_LOG_ERROR(AD5593R_EVENT_NOT_A_DAC, DAC_channel, 0);
+    return AD5593R_ERROR_ROLE;
+  }
+  if (ADC_channel > 7 || device.config.ADCs[ADC_channel] == 0) {
+    AD5593R_LOG_ERROR(AD5593R_EVENT_NOT_AN_ADC, ADC_channel, 0);
+    return AD5593R_ERROR_ROLE;
+  }
+  if (device._ADC_max_mV == 0 || device._DAC_max_mV == 0) {
+    AD5593R_LOG_ERROR(AD5593R_EVENT_NO_VREF, 0xff, 0);
+    return AD5593R_ERROR_NO_VREF;
+  }
+  if (samples == 0) samples = 1;
+
+  //measure the raw DAC, at 5% and 95% of the range to stay clear of the rails
+  AD5593R_Status status = AD5593R_OK;
+  const uint16_t* DAC_table = device._DAC_tables[DAC_channel];
+  uint16_t restore = device.values.DAC_codes[DAC_channel];
+  device._DAC_tables[DAC_channel] = nullptr;
+  int32_t codes[2] = {205, 3890};
+  //with a smaller ADC range the high point has to stay below where the ADC saturates
+  if (device._ADC_max_mV < device._DAC_max_mV) {
+    codes[1] = codes[1] * device._ADC_max_mV / device._DAC_max_mV;
+  }
+  int64_t measured[2];
+  for (int point = 0; point < 2 && status == AD5593R_OK; point++) {
+    status = device.write_DAC_code(DAC_channel, codes[point]);
+    uint32_t sum = 0;
+    for (size_t i = 0; i < samples && status == AD5593R_OK; i++) {
+      int code = device.read_ADC_code(ADC_channel);
+      if (code < 0) status = AD5593R_Status(code);
+      else sum += code;
+    }
+    //the average in DAC codes with 16 fractional bits, the two ranges may differ
+    measured[point] = (int64_t(sum) << 16) * device._ADC_max_mV / (int64_t(samples) * device._DAC_max_mV);
+  }
+  device._DAC_tables[DAC_channel] = DAC_table;
+  device.write_DAC_code(DAC_channel, restore);
+
+  if (status != AD5593R_OK) return status;
+  if (measured[1] <= measured[0]) return AD5593R_ERROR_RANGE;
+  //the output follows measured = a * code + b, so the code for a wanted output is (wanted - b) / a
+  int64_t gain = (int64_t(codes[1] - codes[0]) << 32) / (measured[1] - measured[0]);
+  int64_t offset = (int64_t(codes[0]) << 16) - ((measured[0] * gain) >> 16);
+  DAC_calibration->gain = gain;
+  DAC_calibration->offset = offset;
+  DAC_calibration->points = nullptr;
+  DAC_calibration->num_of_points = 0;
+  return AD5593R_OK;
+}
@@ -0,0 +1,53 @@
+/*
+Per-channel calibration.
+
+A calibration (gain, offset and optional piecewise-linear points) is compiled once into a table of
+4096 codes with build_table(), and the table is handed to the device with set_ADC_table() or
+set_DAC_table(). From then on every correction is a single table lookup: an ADC result is replaced
+by table[raw code], and a DAC code is written as table[code]. No floating point is used per sample.
+
+Each table takes 8 kB and is supplied by the caller, so it can be placed wherever there is room
+(or in flash, if it was built ahead of time). It must outlive its use by the device.
+
+measure_loopback() drives a DAC and reads it back through an ADC on the same chip to produce
+the DAC calibration, taking the ADC (with its own table, if set) as the reference. The DAC and the
+ADC may be the same pin when it is configured as both, or two pins wired together.
+*/
+#pragma once
+#include <Arduino.h>
+#include "AD5593R.h"
+
+#define AD5593R_CALIBRATION_TABLE_SIZE 4096
+
+struct AD5593R_Calibration {
+  // corrected = raw * gain + offset, both with 16 fractional bits
+  int32_t gain;
+  int32_t offset;
+
+  // Optional piecewise-linear correction applied after gain and offset, num_of_points pairs of
+  // {input code, output code} with increasing inputs. Codes outside the first and last point are
+  // extrapolated from the nearest segment. nullptr for none.
+  const uint16_t* points;
+  byte num_of_points;
+
+  // the identity, a table built from it leaves every code as it is
+  static AD5593R_Calibration identity();
+
+  // a calibration with the given gain and offset (in codes), converted to fixed point once
+  static AD5593R_Calibration from_gain_offset(float gain, float offset);
+
+  // fills table with the corrected code of every raw code, clipped to 0-4095
+  void build_table(uint16_t* table) const;
+
+  // Applies the calibration to a single code, as build_table() does.
+  uint16_t apply(uint16_t code) const;
+
+  // Writes two codes near the ends of the range to DAC_channel, reads each back samples times through
+  // ADC_channel and stores the DAC calibration that makes the ADC read the requested code in
+  // DAC_calibration. The DAC table of DAC_channel is ignored while measuring, and the last code written
+  // to it is restored afterwards. Returns AD5593R_OK on success, AD5593R_ERROR_ROLE if a channel has the
+  // wrong role, AD5593R_ERROR_NO_VREF if no reference voltage is specified, AD5593R_ERROR_RANGE if the ADC
+  // does not follow the DAC, or the error of a failed transaction.
+  static AD5593R_Status measure_loopback(AD5593R& device, byte DAC_channel, byte ADC_channel,
+                              AD5593R_Calibration* DAC_calibration, size_t samples = 16);
+};
@@ -0,0 +1,83 @@
+#include "AD5593R_Capture.h"
+
+AD5593R_Capture::AD5593R_Capture(AD5593R& device, Print& out, byte device_id) :
+  _device(device), _out(out), _device_id(device_id) {
+}
+
+byte AD5593R_Capture::scan() {
+  uint16_t codes[8];
+  uint32_t time = micros();
+  byte channels = _device.read_ADC_codes(codes);
+  if (channels != 0) add(channels, codes, time);
+  return channels;
+}
+
+void AD5593R_Capture::add(byte channels, const uint16_t* codes, uint32_t time) {
+  byte flags = _device._ADC_2x_mode ? 0x01 : 0x00;
+  uint16_t Vref_mV = _device._Vref > 0 ? uint16_t(_device._Vref * 1000 + 0.5f) : 0;
+  if (_scans > 0 && (channels != _channels || flags != _flags || Vref_mV != _Vref_mV || time - _last_time > 0xffff)) {
+    flush();
+  }
+  if (_scans == 0) {
+    _channels = channels;
+    _flags = flags;
+    _Vref_mV = Vref_mV;
+    _first_time = time;
+    _last_time = time;
+  }
+  uint16_t delta = time - _last_time;
+  _last_time = time;
+  _deltas[2 * _scans] = delta & 0xff;
+  _deltas[2 * _scans + 1] = delta >> 8;
+  for (int i = 0; i < 8; i++) {
+    if (channels & (1 << i)) _put_code(codes[i]);
+  }
+  if (++_scans == AD5593R_CAPTURE_SCANS) flush();
+}
+
+void AD5593R_Capture::_put_code(uint16_t code) {
+  code &= 0x0fff;
+  if (_half_byte) {
+    _codes[_code_bytes - 1] |= code >> 8;
+    _codes[_code_bytes++] = code & 0xff;
+    _half_byte = 0;
+  }
+  else {
+    _codes[_code_bytes++] = code >> 4;
+    _codes[_code_bytes++] = (code & 0x0f) << 4;
+    _half_byte = 1;
+  }
+}
+
+void AD5593R_Capture::flush() {
+  if (_scans == 0) return;
+  byte header[AD5593R_CAPTURE_HEADER_SIZE] = {
+    AD5593R_CAPTURE_SYNC_0, AD5593R_CAPTURE_SYNC_1, AD5593R_CAPTURE_VERSION, _device_id, _channels, _flags,
+    byte(_Vref_mV & 0xff), byte(_Vref_mV >> 8), _scans,
+    byte(_first_time & 0xff), byte((_first_time >> 8) & 0xff), byte((_first_time >> 16) & 0xff), byte(_first_time >> 24)
+  };
+  uint16_t crc = crc16(header + 2, sizeof(header) - 2);
+  crc = crc16(_deltas, 2 * _scans, crc);
+  crc = crc16(_codes, _code_bytes, crc);
+  byte trailer[2] = {byte(crc & 0xff), byte(crc >> 8)};
+
+  _out.write(header, sizeof(header));
+  _out.write(_deltas, 2 * _scans);
+  _out.write(_codes, _code_bytes);
+  _out.write(trailer, 2);
+  _frames++;
+
+  _scans = 0;
+  _code_bytes = 0;
+  _half_byte = 0;
+}
+
+uint16_t AD5593R_Capture::crc16(const byte* data, size_t length, uint16_t crc) {
+  for (size_t i = 0; i < length; i++) {
+    crc ^= uint16_t(data[i]) << 8;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+  }
+  return crc;
+}
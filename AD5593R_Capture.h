@@ -0,0 +1,80 @@
+/*
+Compact binary capture of ADC scans, for streaming acquisitions off the device.
+
+Scans (the codes of a set of channels converted in one sequence) are collected into frames and
+written to any Print, e.g. Serial. A frame costs 15 bytes plus 2 per scan, and each code only
+1.5 bytes, against about 6 bytes per value for printed floats. extras/host/AD5593R_Capture_Reader.h
+decodes the frames on a PC.
+
+Frame layout, multi-byte fields are little endian:
+  0    2   sync bytes 0xA5 0x5A
+  2    1   format version, 1
+  3    1   device id, given to the writer
+  4    1   channel mask, bit n set if channel n is in the scans
+  5    1   flags, bit 0 set if the ADC range is 2x Vref
+  6    2   Vref in mV, 0 if none is specified
+  8    1   number of scans n, 1-255
+  9    4   micros() of the first scan
+  13   2n  time of each scan since the previous one in us, 0 for the first
+  ..       codes, scan by scan and channel by channel in increasing order, two codes in three bytes:
+           [a11-a4] [a3-a0 b11-b8] [b7-b0]. An odd last code takes two bytes, [a11-a4] [a3-a0 0000]
+  ..   2   CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF) of everything after the sync bytes
+A new frame is started when the channels, Vref or range change, or when a scan comes more than
+65535 us after the previous one.
+*/
+#pragma once
+#include <Arduino.h>
+#include "AD5593R.h"
+
+// scans collected before a frame is written
+#ifndef AD5593R_CAPTURE_SCANS
+#define AD5593R_CAPTURE_SCANS 16
+#endif
+
+#define AD5593R_CAPTURE_SYNC_0 0xA5
+#define AD5593R_CAPTURE_SYNC_1 0x5A
+#define AD5593R_CAPTURE_VERSION 1
+#define AD5593R_CAPTURE_HEADER_SIZE 13
+
+class AD5593R_Capture {
+public:
+  // frames are written to out, tagged with device_id
+  AD5593R_Capture(AD5593R& device, Print& out, byte device_id = 0);
+
+  // Reads every ADC channel with read_ADC_codes() and adds the scan, stamped with micros().
+  // Returns the mask of the channels read, 0 if the read failed and nothing was added
+  byte scan();
+
+  // adds a scan of the channels in the mask channels, codes[channel] holds their codes, time is micros()
+  void add(byte channels, const uint16_t* codes, uint32_t time);
+
+  // writes the scans collected so far as a frame, call it before a pause in the capture
+  void flush();
+
+  unsigned long frames() const { return _frames; }
+
+  // CRC-16/CCITT-FALSE of length bytes, continuing from crc
+  static uint16_t crc16(const byte* data, size_t length, uint16_t crc = 0xFFFF);
+
+private:
+  void _put_code(uint16_t code);
+
+  AD5593R& _device;
+  Print& _out;
+  byte _device_id;
+
+  // fields of the frame being collected
+  byte _channels = 0;
+  byte _flags = 0;
+  uint16_t _Vref_mV = 0;
+  byte _scans = 0;
+  uint32_t _first_time = 0;
+  uint32_t _last_time = 0;
+
+  byte _deltas[2 * AD5593R_CAPTURE_SCANS];
+  byte _codes[(3 * 8 * AD5593R_CAPTURE_SCANS + 1) / 2];
+  size_t _code_bytes = 0;
+  bool _half_byte = 0;  // the last code byte only holds the high nibble
+
+  unsigned long _frames = 0;
+};
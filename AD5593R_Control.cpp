@@ -0,0 +1,165 @@
+#include "AD5593R_Control.h"
+
+static int32_t to_fixed(float gain) {
+  return int32_t(gain * 65536 + (gain < 0 ? -0.5f : 0.5f));
+}
+
+AD5593R_Control::AD5593R_Control(AD5593R& device) : _device(device) {
+  reset_stats();
+}
+
+int AD5593R_Control::add_loop(byte ADC_channel, byte DAC_channel, float kp, float ki, float kd) {
+  if (ADC_channel > 7 || DAC_channel > 7 || !_device.config.ADCs[ADC_channel] || !_device.config.DACs[DAC_channel]) {
+    return AD5593R_ERROR_ROLE;
+  }
+  if (_num_of_loops == AD5593R_CONTROL_LOOPS) return AD5593R_ERROR_RANGE;
+  byte index = _num_of_loops++;
+  _loop& loop = _loops[index];
+  loop.ADC_channel = ADC_channel;
+  loop.DAC_channel = DAC_channel;
+  loop.setpoint = 0;
+  loop.min = 0;
+  loop.max = 4095;
+  loop.integral = 0;
+  loop.input = 0;
+  loop.output = _device.values.DAC_codes[DAC_channel];
+  loop.primed = 0;
+  set_gains(index, kp, ki, kd);
+  _inputs |= 1 << ADC_channel;
+  return index;
+}
+
+void AD5593R_Control::set_gains(byte loop, float kp, float ki, float kd) {
+  _loops[loop].kp = to_fixed(kp);
+  _loops[loop].ki = to_fixed(ki);
+  _loops[loop].kd = to_fixed(kd);
+}
+
+void AD5593R_Control::set_setpoint(byte loop, uint16_t code) {
+  _loops[loop].setpoint = code;
+}
+
+void AD5593R_Control::set_output_limits(byte loop, uint16_t min, uint16_t max) {
+  _loops[loop].min = min;
+  _loops[loop].max = max > 4095 ? 4095 : max;
+}
+
+void AD5593R_Control::reset() {
+  for (byte i = 0; i < _num_of_loops; i++) {
+    _loops[i].integral = 0;
+    _loops[i].primed = 0;
+  }
+}
+
+uint16_t AD5593R_Control::_step(_loop& loop, uint16_t input) {
+  int32_t error = int32_t(loop.setpoint) - input;
+  int64_t low = int64_t(loop.min) << 16;
+  int64_t high = int64_t(loop.max) << 16;
+
+  //the integral is kept inside the output range, so it does not wind up while the output is clamped
+  loop.integral += int64_t(loop.ki) * error;
+  if (loop.integral < low) loop.integral = low;
+  if (loop.integral > high) loop.integral = high;
+
+  int64_t output = int64_t(loop.kp) * error + loop.integral;
+  if (loop.primed) output += int64_t(loop.kd) * (int32_t(loop.input) - input);
+  loop.input = input;
+  loop.primed = 1;
+
+  //round to the nearest code
+  output = (output + 0x8000) >> 16;
+  if (output < loop.min) output = loop.min;
+  if (output > loop.max) output = loop.max;
+  return uint16_t(output);
+}
+
+AD5593R_Status AD5593R_Control::tick() {
+  uint16_t codes[8];
+  byte channels = _device.read_ADC_codes(codes);
+  if ((channels & _inputs) != _inputs) {
+    _stats.errors++;
+    if (channels != 0) return AD5593R_ERROR_RANGE;
+    return _device.online() ? AD5593R_ERROR_SHORT_READ : AD5593R_ERROR_OFFLINE;
+  }
+
+  //DAC channels without a loop are written with the code they already have
+  uint16_t outputs[8];
+  for (int i = 0; i < 8; i++) {
+    outputs[i] = _device.values.DAC_codes[i];
+  }
+  uint16_t new_outputs[AD5593R_CONTROL_LOOPS];
+  for (byte i = 0; i < _num_of_loops; i++) {
+    new_outputs[i] = _step(_loops[i], codes[_loops[i].ADC_channel]);
+    outputs[_loops[i].DAC_channel] = new_outputs[i];
+  }
+  AD5593R_Status status = _device.write_DAC_codes(outputs);
+  if (status != AD5593R_OK) {
+    _stats.errors++;
+    return status;
+  }
+  for (byte i = 0; i < _num_of_loops; i++) {
+    _loops[i].output = new_outputs[i];
+  }
+  return AD5593R_OK;
+}
+
+void AD5593R_Control::start(uint32_t period) {
+  reset_stats();
+  _period = period;
+  _stats.period = period;
+  _next = uint32_t(micros());
+  _running = 1;
+}
+
+void AD5593R_Control::stop() {
+  _running = 0;
+}
+
+bool AD5593R_Control::poll() {
+  if (!_running) return 0;
+  uint32_t now = uint32_t(micros());
+  int32_t late = int32_t(now - _next);
+  if (late < 0) return 0;
+  //deadlines that have already passed are skipped, the grid stays where it was
+  if (uint32_t(late) >= _period && _period > 0) {
+    uint32_t missed = uint32_t(late) / _period;
+    _stats.overruns += missed;
+    _next += missed * _period;
+    late -= missed * _period;
+  }
+  _next += _period;
+
+  tick();
+  uint32_t tick_time = uint32_t(micros()) - now;
+
+  if (_stats.ticks == 0) _first_start = now;
+  _last_start = now;
+  _stats.ticks++;
+  _jitter_sum += late;
+  if (uint32_t(late) > _stats.max_jitter) _stats.max_jitter = late;
+  _stats.last_tick_time = tick_time;
+  if (tick_time > _stats.max_tick_time) _stats.max_tick_time = tick_time;
+  return 1;
+}
+
+void AD5593R_Control::get_stats(AD5593R_Control_Stats* stats) const {
+  *stats = _stats;
+  stats->mean_jitter = _stats.ticks ? uint32_t(_jitter_sum / _stats.ticks) : 0;
+  uint32_t elapsed = _last_start - _first_start;
+  stats->rate = (_stats.ticks > 1 && elapsed > 0) ? (_stats.ticks - 1) * 1e6f / elapsed : 0;
+}
+
+void AD5593R_Control::reset_stats() {
+  _stats.ticks = 0;
+  _stats.overruns = 0;
+  _stats.errors = 0;
+  _stats.period = _period;
+  _stats.max_jitter = 0;
+  _stats.mean_jitter = 0;
+  _stats.max_tick_time = 0;
+  _stats.last_tick_time = 0;
+  _stats.rate = 0;
+  _jitter_sum = 0;
+  _first_start = 0;
+  _last_start = 0;
+}
@@ -0,0 +1,112 @@
+/*
+Fixed-rate closed-loop control on the driver: ADC channels in, DAC channels out.
+
+Each loop binds an ADC input to a DAC output through an integer PID controller. One tick() is
+  one sequenced read of every ADC (read_ADC_codes()), the controllers of all loops in fixed point,
+  and one burst write of every DAC (write_DAC_codes(), the outputs change together),
+so a tick costs four transactions however many loops there are, and no floating point.
+
+The controllers work in codes: error = setpoint - input, and
+  output = kp * error + sum(ki * error) + kd * (previous input - input)
+with the gains in 16 fractional bits. ki and kd are per tick, so for gains given per second use
+ki = Ki * period and kd = Kd / period. The derivative acts on the input, so a setpoint change does not
+kick the output. The output is clamped to its limits and the integral stops growing at them.
+
+start(period) runs the loops at a fixed rate from poll(), which must be called more often than the
+period (e.g. from loop()). Ticks are scheduled on a fixed grid, start + n * period, so the rate does
+not drift with the tick time. get_stats() reports the measured rate, how late each tick started
+(jitter) and the ticks that were missed (overruns). DAC channels without a loop keep their last code.
+*/
+#pragma once
+#include <Arduino.h>
+#include "AD5593R.h"
+
+// a loop takes two of the 8 pins
+#define AD5593R_CONTROL_LOOPS 4
+
+struct AD5593R_Control_Stats {
+  unsigned long ticks;
+  unsigned long overruns;       // ticks missed because poll() came more than a period late
+  unsigned long errors;         // ticks whose read or write failed, the outputs were left as they were
+  uint32_t period;              // us
+  uint32_t max_jitter;          // us, latest start of a tick after its deadline
+  uint32_t mean_jitter;         // us
+  uint32_t max_tick_time;       // us, longest tick
+  uint32_t last_tick_time;      // us
+  float rate;                   // ticks per second, measured
+};
+
+class AD5593R_Control {
+public:
+  AD5593R_Control(AD5593R& device);
+
+  // Binds ADC_channel to DAC_channel with the given gains, the setpoint starts at 0 and the output
+  // limits at 0-4095. Returns the index of the loop, AD5593R_ERROR_ROLE if the channels do not have
+  // those roles, or AD5593R_ERROR_RANGE if all AD5593R_CONTROL_LOOPS loops are in use
+  int add_loop(byte ADC_channel, byte DAC_channel, float kp, float ki = 0, float kd = 0);
+
+  // gains are converted to fixed point here, not on every tick
+  void set_gains(byte loop, float kp, float ki, float kd);
+
+  // target of the input, in ADC codes
+  void set_setpoint(byte loop, uint16_t code);
+
+  // range of the output in DAC codes, also the range of the integral
+  void set_output_limits(byte loop, uint16_t min, uint16_t max);
+
+  // clears the integral and derivative state of every loop
+  void reset();
+
+  // One control step, returns AD5593R_OK, the error of the write, AD5593R_ERROR_SHORT_READ (or
+  // AD5593R_ERROR_OFFLINE) if the read failed, or AD5593R_ERROR_RANGE if a loop input was missing from it
+  AD5593R_Status tick();
+
+  // Runs tick() every period us from poll(), the first tick is on the next poll()
+  void start(uint32_t period);
+  void stop();
+  bool running() const { return _running; }
+
+  // runs a tick if one is due, returns 1 if it did
+  bool poll();
+
+  uint16_t input(byte loop) const { return _loops[loop].input; }
+  uint16_t output(byte loop) const { return _loops[loop].output; }
+
+  // integral term of a loop in DAC codes, rounded down
+  int32_t integral(byte loop) const { return int32_t(_loops[loop].integral >> 16); }
+
+  void get_stats(AD5593R_Control_Stats* stats) const;
+  void reset_stats();
+
+private:
+  struct _loop {
+    byte ADC_channel;
+    byte DAC_channel;
+    uint16_t setpoint;
+    uint16_t min;
+    uint16_t max;
+    int32_t kp;           // 16 fractional bits
+    int32_t ki;
+    int32_t kd;
+    int64_t integral;     // in codes, 16 fractional bits
+    uint16_t input;
+    uint16_t output;
+    bool primed;          // input holds a previous sample for the derivative
+  };
+
+  uint16_t _step(_loop& loop, uint16_t input);
+
+  AD5593R& _device;
+  _loop _loops[AD5593R_CONTROL_LOOPS];
+  byte _num_of_loops = 0;
+  byte _inputs = 0;       // mask of the loop inputs
+
+  bool _running = 0;
+  uint32_t _period = 0;
+  uint32_t _next = 0;     // deadline of the next tick
+
+  AD5593R_Control_Stats _stats;
+  uint64_t _jitter_sum = 0;
+  uint32_t _first_start = 0;
+  uint32_t _last_start = 0;
+};
@@ -0,0 +1,213 @@
+#include "AD5593R_Filter.h"
+#include "AD5593R_Monitor.h"
+#include "AD5593R_Registers.h"
+
+// sum of count codes, written as a plain loop over a contiguous array so it can be vectorized
+static uint32_t _sum(const uint16_t* codes, size_t count) {
+  uint32_t sum = 0;
+  for (size_t i = 0; i < count; i++) {
+    sum += codes[i];
+  }
+  return sum;
+}
+
+AD5593R_Filter::AD5593R_Filter(AD5593R& device) : _device(device) {
+  for (int i = 0; i < 8; i++) {
+    _type[i] = AD5593R_FILTER_NONE;
+    _parameter[i] = 0;
+    _output[i] = 0;
+  }
+  reset();
+}
+
+AD5593R_Status AD5593R_Filter::_configure(byte channel, byte type, byte parameter) {
+  if (channel > 7 || _device.config.ADCs[channel] == 0) {
+    AD5593R_LOG_ERROR(AD5593R_EVENT_NOT_AN_ADC, channel, 0);
+    return AD5593R_ERROR_ROLE;
+  }
+  _type[channel] = type;
+  _parameter[channel] = parameter;
+  _state[channel] = 0;
+  _count[channel] = 0;
+  _window_head[channel] = 0;
+  return AD5593R_OK;
+}
+
+AD5593R_Status AD5593R_Filter::set_decimation(byte channel, byte bits) {
+  if (bits > 4) return AD5593R_ERROR_RANGE;
+  return _configure(channel, AD5593R_FILTER_DECIMATE, bits);
+}
+
+AD5593R_Status AD5593R_Filter::set_moving_average(byte channel, byte length) {
+  if (length == 0 || length > AD5593R_FILTER_MAX_LENGTH) return AD5593R_ERROR_RANGE;
+  return _configure(channel, AD5593R_FILTER_AVERAGE, length);
+}
+
+AD5593R_Status AD5593R_Filter::set_IIR(byte channel, byte shift) {
+  if (shift == 0 || shift > 15) return AD5593R_ERROR_RANGE;
+  return _configure(channel, AD5593R_FILTER_IIR, shift);
+}
+
+void AD5593R_Filter::disable(byte channel) {
+  if (channel > 7) return;
+  _type[channel] = AD5593R_FILTER_NONE;
+}
+
+void AD5593R_Filter::reset() {
+  for (int i = 0; i < 8; i++) {
+    _state[i] = 0;
+    _count[i] = 0;
+    _window_head[i] = 0;
+  }
+}
+
+int AD5593R_Filter::update(size_t passes) {
+  AD5593R::_publish_scope publish(_device);
+  byte channels = 0;
+  size_t num_of_channels = 0;
+  for (int i = 0; i < 8; i++) {
+    if (_type[i] != AD5593R_FILTER_NONE && _device.config.ADCs[i] == 1) {
+      channels |= 1 << i;
+      num_of_channels++;
+    }
+  }
+  if (channels == 0) {
+    AD5593R_LOG_ERROR(AD5593R_EVENT_NO_ADCS, 0xff, 0);
+    return AD5593R_ERROR_ROLE;
+  }
+  if (_device._ADC_max == -1) {
+    AD5593R_LOG_ERROR(AD5593R_EVENT_NO_VREF, 0xff, 0);
+    return AD5593R_ERROR_NO_VREF;
+  }
+#ifdef AD5593R_STATS
+  AD5593R_Stats_Scope stats_scope(_device._stats, _device._stats_operation, AD5593R_OP_READ_ADCS);
+#endif
+
+  _device._select();
+  //with the repeat bit set the sequencer wraps around, so every read returns the next conversion
+  AD5593R_Status status = _device._update_register(_ADAC_ADC_SEQUENCE, (uint16_t(_ADAC_SEQUENCE_ON) << 8) | channels);
+  if (status == AD5593R_OK && _device._read_pointer != _ADAC_ADC_READ) {
+    status = _device._write_pointer(_ADAC_ADC_READ);
+  }
+  if (status != AD5593R_OK) {
+    _device._deselect();
+    return status;
+  }
+  byte buffer[AD5593R_MAX_TRANSFER];
+  byte updated = 0;
+  size_t remaining = passes * num_of_channels;
+  while (remaining > 0) {
+    size_t count = remaining;
+    if (count > AD5593R_MAX_TRANSFER / 2) count = AD5593R_MAX_TRANSFER / 2;
+    size_t received = _device._read(buffer, 2 * count) / 2;
+    updated |= _process(buffer, received);
+    remaining -= received;
+    if (received < count) break;
+  }
+  _device._deselect();
+
+  for (int i = 0; i < 8; i++) {
+    if (updated & (1 << i)) _publish(i);
+  }
+  return updated;
+}
+
+byte AD5593R_Filter::_process(const byte* buffer, size_t samples) {
+  //counting sort by the channel in bits 12-14 of each result, giving one contiguous run per channel
+  uint16_t sorted[AD5593R_MAX_TRANSFER / 2];
+  size_t start[9] = {0};
+  for (size_t i = 0; i < samples; i++) {
+    start[((buffer[2 * i] >> 4) & 0x07) + 1]++;
+  }
+  for (int i = 0; i < 8; i++) {
+    start[i + 1] += start[i];
+  }
+  size_t position[8];
+  for (int i = 0; i < 8; i++) {
+    position[i] = start[i];
+  }
+  for (size_t i = 0; i < samples; i++) {
+    byte channel = (buffer[2 * i] >> 4) & 0x07;
+    sorted[position[channel]++] = _device._ADC_code(channel, (uint16_t(buffer[2 * i] & 0x0f) << 8) | buffer[2 * i + 1]);
+  }
+
+  byte updated = 0;
+  for (int i = 0; i < 8; i++) {
+    size_t count = start[i + 1] - start[i];
+    if (count == 0 || _type[i] == AD5593R_FILTER_NONE) continue;
+    if (_filter(i, sorted + start[i], count)) updated |= 1 << i;
+  }
+  return updated;
+}
+
+bool AD5593R_Filter::_filter(byte channel, const uint16_t* codes, size_t count) {
+  byte parameter = _parameter[channel];
+  bool updated = 0;
+  switch (_type[channel]) {
+    case AD5593R_FILTER_DECIMATE: {
+      //blocks may span several batches, the sum of 4^4 codes still fits in 20 bits
+      size_t length = size_t(1) << (2 * parameter);
+      while (count > 0) {
+        size_t take = length - _count[channel];
+        if (take > count) take = count;
+        _state[channel] += _sum(codes, take);
+        _count[channel] += take;
+        codes += take;
+        count -= take;
+        if (_count[channel] == length) {
+          _output[channel] = (_state[channel] << 4) >> (2 * parameter);
+          _state[channel] = 0;
+          _count[channel] = 0;
+          updated = 1;
+        }
+      }
+      break;
+    }
+    case AD5593R_FILTER_AVERAGE: {
+      //only the newest length codes can end up in the window
+      if (count > parameter) {
+        codes += count - parameter;
+        count = parameter;
+      }
+      uint16_t* window = _window[channel];
+      byte head = _window_head[channel];
+      for (size_t i = 0; i < count; i++) {
+        window[head] = codes[i];
+        if (++head == parameter) head = 0;
+      }
+      _window_head[channel] = head;
+      //until the window has filled up the codes are in its first _count entries
+      if (_count[channel] + count > parameter) _count[channel] = parameter;
+      else _count[channel] += count;
+      _output[channel] = (_sum(window, _count[channel]) << 4) / _count[channel];
+      updated = 1;
+      break;
+    }
+    case AD5593R_FILTER_IIR: {
+      //the output is kept with 16 fractional bits, the recurrence is inherently serial
+      int32_t state = _state[channel];
+      size_t i = 0;
+      if (_count[channel] == 0) {
+        state = int32_t(codes[0]) << 16;
+        _count[channel] = 1;
+        i = 1;
+      }
+      for (; i < count; i++) {
+        state += ((int32_t(codes[i]) << 16) - state) >> parameter;
+      }
+      _state[channel] = state;
+      _output[channel] = state >> 12;
+      updated = 1;
+      break;
+    }
+  }
+  return updated;
+}
+
+void AD5593R_Filter::_publish(byte channel) {
+  uint16_t output = _output[channel];
+  _device.values.ADC_codes[channel] = (output + 8) >> 4;
+  _device.values.ADCs[channel] = output * _device._ADC_volts_per_code * (1.0f / 16);
+  _device._values_changed = 1;
+  if (_device._monitor) _device._monitor->_ADC(channel, _device.values.ADC_codes[channel]);
+}
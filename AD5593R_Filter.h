@@ -0,0 +1,86 @@
+/*
+Per-channel ADC filtering on the driver.
+
+update() reads a batch of conversions of every filtered channel with one sequenced scan (the repeat
+bit of the sequence register is set, so the conversions are clocked out back to back in as few
+transactions as AD5593R_MAX_TRANSFER allows), sorts the batch by channel and runs each channel's filter
+over its samples:
+  decimation      block average of 4^bits samples, a new result every 4^bits samples, which gains
+                  bits of resolution when the input carries some noise
+  moving average  average of the last length samples, a new result on every update()
+  IIR             first order low pass y += (x - y) / 2^shift, a new result on every update()
+The filters only use integer arithmetic. Results are kept as 16-bit values, the 12-bit code with 4
+fractional bits, and published to values.ADCs (volts) and values.ADC_codes (rounded) of the device.
+
+The kernels work on contiguous runs of samples per channel, so the sums compile to vector code
+in the host build. All filter state is kept in the object, about 350 bytes.
+*/
+#pragma once
+#include <Arduino.h>
+#include "AD5593R.h"
+
+// longest moving average
+#ifndef AD5593R_FILTER_MAX_LENGTH
+#define AD5593R_FILTER_MAX_LENGTH 16
+#endif
+
+enum AD5593R_Filter_Type {
+  AD5593R_FILTER_NONE,
+  AD5593R_FILTER_DECIMATE,
+  AD5593R_FILTER_AVERAGE,
+  AD5593R_FILTER_IIR
+};
+
+class AD5593R_Filter {
+public:
+  AD5593R_Filter(AD5593R& device);
+
+  // Each of these sets up the filter of one ADC channel and clears its state.
+  // They return AD5593R_OK, AD5593R_ERROR_ROLE if the channel is not an ADC, or AD5593R_ERROR_RANGE if the
+  // parameter is out of range.
+
+  // block average of 4^bits samples, bits 0-4
+  AD5593R_Status set_decimation(byte channel, byte bits);
+
+  // average of the last length samples, length 1-AD5593R_FILTER_MAX_LENGTH
+  AD5593R_Status set_moving_average(byte channel, byte length);
+
+  // first order IIR with a smoothing factor of 1/2^shift, shift 1-15
+  AD5593R_Status set_IIR(byte channel, byte shift);
+
+  // stops filtering a channel, it is no longer read by update()
+  void disable(byte channel);
+
+  // clears the state of every filter, the next results only depend on new samples
+  void reset();
+
+  // Reads passes conversions of every filtered channel and runs the filters over them.
+  // Returns a bit mask of the channels with a new result, AD5593R_ERROR_ROLE if no filtered channel is an ADC,
+  // AD5593R_ERROR_NO_VREF if no reference voltage is specified, or the error of a failed transaction.
+  int update(size_t passes = 1);
+
+  // last result of a channel, a 12-bit code with 4 fractional bits
+  uint16_t get(byte channel) const { return _output[channel & 0x07]; }
+
+private:
+  // runs a channel's filter over count samples, returns 1 if it produced a new result
+  bool _filter(byte channel, const uint16_t* codes, size_t count);
+
+  // sorts a batch of conversion results by channel and filters them, returns the updated channels
+  byte _process(const byte* buffer, size_t samples);
+
+  // stores the result of a channel in the device values
+  void _publish(byte channel);
+
+  AD5593R_Status _configure(byte channel, byte type, byte parameter);
+
+  AD5593R& _device;
+
+  byte _type[8];
+  byte _parameter[8];      // bits, length or shift, depending on the type
+  uint32_t _state[8];      // decimation sum, or IIR output with 16 fractional bits
+  uint16_t _count[8];      // samples in the decimation block or the moving average window
+  byte _window_head[8];
+  uint16_t _window[8][AD5593R_FILTER_MAX_LENGTH];
+  uint16_t _output[8];
+};
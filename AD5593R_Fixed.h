@@ -0,0 +1,223 @@
+/*
+AD5593R with the pin roles fixed at compile time.
+
+The roles, reference and ranges of every pin are given by a channel map type, e.g.
+  typedef AD5593R_Channel_Map<0b00001111, 0b11110000> Map;  // ADCs on 0-3, DACs on 4-7
+  AD5593R_Fixed<Map> device(a0);
+The register values of the map are constants, and the channel of a call is a template argument,
+  device.write_DAC_code<4>(2048);
+  int code = device.read_ADC_code<0>();
+so using a pin in a role it does not have fails to compile instead of returning AD5593R_ERROR_ROLE, and
+the calls carry no role checks. A pin given two roles in a map also fails to compile.
+
+The object only holds the transport, the a0 pin, the last read pointer and the GPO levels (a few bytes,
+against several hundred for AD5593R), so the calls only work in codes. Transactions go through the same
+code as AD5593R's (AD5593R_Transfer.h): they are retried AD5593R_RETRIES times with the AD5593R_RETRY_BACKOFF
+backoff and split as AD5593R_MAX_TRANSFER and AD5593R_BURST_WRITES require, there is no health tracking.
+*/
+#pragma once
+#include <Arduino.h>
+#include "AD5593R_Transport.h"
+#include "AD5593R_Status.h"
+#include "AD5593R_Transfer.h"
+#include "AD5593R_Registers.h"
+
+// flags of a channel map
+#define AD5593R_MAP_INTERNAL_VREF 0x01  // the internal 2.5V reference is enabled
+#define AD5593R_MAP_ADC_2X        0x02  // the ADC range is 0-2xVref
+#define AD5593R_MAP_DAC_2X        0x04  // the DAC range is 0-2xVref
+
+constexpr byte AD5593R_count_bits(byte bits) {
+  return bits ? (bits & 1) + AD5593R_count_bits(bits >> 1) : 0;
+}
+
+// bit n of each mask gives pin n that role
+template <byte ADC_pins, byte DAC_pins, byte GPI_pins = 0, byte GPO_pins = 0, byte map_flags = 0>
+struct AD5593R_Channel_Map {
+  static constexpr byte ADCs = ADC_pins;
+  static constexpr byte DACs = DAC_pins;
+  static constexpr byte GPIs = GPI_pins;
+  static constexpr byte GPOs = GPO_pins;
+  static constexpr byte flags = map_flags;
+
+  static_assert((ADCs & DACs) == 0 && (ADCs & GPIs) == 0 && (ADCs & GPOs) == 0 &&
+                (DACs & GPIs) == 0 && (DACs & GPOs) == 0 && (GPIs & GPOs) == 0,
+                "a pin of an AD5593R_Channel_Map can only have one role");
+
+  static constexpr byte num_of_ADCs = AD5593R_count_bits(ADCs);
+  static constexpr byte num_of_DACs = AD5593R_count_bits(DACs);
+  // unused pins are pulled down, as they are after a reset
+  static constexpr byte pull_downs = byte(~(ADCs | DACs | GPIs | GPOs));
+  static constexpr byte GP_control = ((flags & AD5593R_MAP_ADC_2X) ? _ADAC_ADC_RANGE_2X : 0) |
+                                     ((flags & AD5593R_MAP_DAC_2X) ? _ADAC_DAC_RANGE_2X : 0);
+  static constexpr byte power_ref_msbs = (flags & AD5593R_MAP_INTERNAL_VREF) ? _ADAC_VREF_ON : 0;
+};
+
+template <class Map>
+class AD5593R_Fixed {
+public:
+  typedef Map channel_map;
+
+  AD5593R_Fixed(AD5593R_Transport& transport, int a0 = -1) : _transport(transport), _a0(a0) {
+    _transport.attach_a0(_a0);
+    _transport.begin();
+  }
+
+  AD5593R_Fixed(int a0 = -1) : AD5593R_Fixed(AD5593R_default_transport(), a0) {
+  }
+
+  // writes the pin roles, reference and ranges of the map in a single transaction, call it once in setup()
+  AD5593R_Status begin() {
+    const byte frames[] = {
+      _ADAC_ADC_CONFIG, 0x00, Map::ADCs,
+      _ADAC_DAC_CONFIG, 0x00, Map::DACs,
+      _ADAC_GPIO_RD_CONFIG, 0x00, Map::GPIs,
+      _ADAC_GPIO_WR_CONFIG, 0x00, Map::GPOs,
+      _ADAC_GPIO_WR_DATA, 0x00, 0x00,
+      _ADAC_PULL_DOWN, 0x00, Map::pull_downs,
+      _ADAC_THREE_STATE, 0x00, 0x00,
+      _ADAC_GP_CONTROL, 0x00, Map::GP_control,
+      _ADAC_POWER_REF_CTRL, Map::power_ref_msbs, 0x00
+    };
+    _GPO_levels = 0;
+    return _transaction(frames, sizeof(frames));
+  }
+
+  // writes the 12-bit code to a DAC channel, AD5593R_ERROR_RANGE if code > 4095
+  template <byte channel>
+  AD5593R_Status write_DAC_code(uint16_t code) {
+    static_assert(channel < 8 && (Map::DACs & (1 << channel)), "the channel is not a DAC in the channel map");
+    if (code > 4095) return AD5593R_ERROR_RANGE;
+    const byte frame[3] = {byte(_ADAC_DAC_WRITE | channel), byte(0x80 | (channel << 4) | (code >> 8)), byte(code & 0xff)};
+    return _transaction(frame, 3);
+  }
+
+  // writes codes[channel] to every DAC of the map, they change at the same time
+  AD5593R_Status write_DAC_codes(const uint16_t* codes) {
+    static_assert(Map::DACs != 0, "the channel map has no DACs");
+    byte frames[3 * (Map::num_of_DACs + 2)];
+    size_t length = 0;
+    frames[length++] = _ADAC_LDAC_MODE;
+    frames[length++] = 0x00;
+    frames[length++] = _ADAC_LDAC_HOLD;
+    for (byte channel = 0; channel < 8; channel++) {
+      if (!(Map::DACs & (1 << channel))) continue;
+      if (codes[channel] > 4095) return AD5593R_ERROR_RANGE;
+      frames[length++] = _ADAC_DAC_WRITE | channel;
+      frames[length++] = 0x80 | (channel << 4) | (codes[channel] >> 8);
+      frames[length++] = codes[channel] & 0xff;
+    }
+    frames[length++] = _ADAC_LDAC_MODE;
+    frames[length++] = 0x00;
+    frames[length++] = _ADAC_LDAC_LOAD;
+    return _transaction(frames, length);
+  }
+
+  // returns the 12-bit code of an ADC channel, or the error of a failed transaction
+  template <byte channel>
+  int read_ADC_code() {
+    static_assert(channel < 8 && (Map::ADCs & (1 << channel)), "the channel is not an ADC in the channel map");
+    byte buffer[2];
+    int status = _read_sequence(1 << channel, buffer, 2);
+    if (status != AD5593R_OK) return status;
+    return ((buffer[0] & 0x0f) << 8) | buffer[1];
+  }
+
+  // Reads every ADC of the map with one sequenced conversion into codes[channel].
+  // Returns a bit mask of the channels read, 0 if the read failed
+  byte read_ADC_codes(uint16_t* codes) {
+    static_assert(Map::ADCs != 0, "the channel map has no ADCs");
+    byte buffer[2 * Map::num_of_ADCs];
+    if (_read_sequence(Map::ADCs, buffer, sizeof(buffer)) != AD5593R_OK) return 0;
+    byte channels = 0;
+    for (size_t i = 0; i < sizeof(buffer); i += 2) {
+      byte channel = (buffer[i] >> 4) & 0x07;
+      codes[channel] = ((buffer[i] & 0x0f) << 8) | buffer[i + 1];
+      channels |= 1 << channel;
+    }
+    return channels & Map::ADCs;
+  }
+
+  // Reads the levels of the GPIs of the map into levels, bit n is channel n, others read as 0.
+  // levels is only written when AD5593R_OK is returned
+  AD5593R_Status read_GPIs(byte& levels) {
+    static_assert(Map::GPIs != 0, "the channel map has no GPIs");
+    byte buffer[2];
+    _select();
+    //the pointer only has to be sent if the last read was not a GPIO read
+    AD5593R_Status status = AD5593R_OK;
+    if (_read_pointer != _ADAC_GPIO_READ) status = _set_pointer(_ADAC_GPIO_READ);
+    if (status == AD5593R_OK && _read(buffer, 2) < 2) status = AD5593R_ERROR_SHORT_READ;
+    _deselect();
+    if (status == AD5593R_OK) levels = buffer[1] & Map::GPIs;
+    return status;
+  }
+
+  // sets the GPOs of the map to levels, bit n is channel n, in one transaction
+  AD5593R_Status write_GPOs(byte levels) {
+    static_assert(Map::GPOs != 0, "the channel map has no GPOs");
+    const byte frame[3] = {_ADAC_GPIO_WR_DATA, 0x00, byte(levels & Map::GPOs)};
+    AD5593R_Status status = _transaction(frame, 3);
+    if (status == AD5593R_OK) _GPO_levels = levels & Map::GPOs;
+    return status;
+  }
+
+  template <byte channel>
+  AD5593R_Status write_GPO(bool level) {
+    static_assert(channel < 8 && (Map::GPOs & (1 << channel)), "the channel is not a GPO in the channel map");
+    return write_GPOs(level ? _GPO_levels | (1 << channel) : _GPO_levels & ~(1 << channel));
+  }
+
+  byte GPO_levels() const { return _GPO_levels; }
+
+private:
+  void _select() { _transport.set_a0(_a0, LOW); }
+  void _deselect() { _transport.set_a0(_a0, HIGH); }
+
+  // register frames, in as few transactions as the transfer size allows
+  AD5593R_Status _transaction(const byte* data, size_t length) {
+    _read_pointer = _ADAC_NULL;
+    _select();
+    AD5593R_Status status = AD5593R_burst(length, [this, data](size_t offset, size_t chunk) {
+      return _write(data + offset, chunk);
+    });
+    _deselect();
+    return status;
+  }
+
+  AD5593R_Status _set_pointer(byte pointer) {
+    AD5593R_Status status = _write(&pointer, 1);
+    _read_pointer = status == AD5593R_OK ? pointer : _ADAC_NULL;
+    return status;
+  }
+
+  // converts the channels once each and reads the results
+  AD5593R_Status _read_sequence(byte channels, byte* buffer, size_t length) {
+    const byte sequence[3] = {_ADAC_ADC_SEQUENCE, 0x00, channels};
+    _read_pointer = _ADAC_NULL;
+    _select();
+    AD5593R_Status status = _write(sequence, 3);
+    if (status == AD5593R_OK) status = _set_pointer(_ADAC_ADC_READ);
+    if (status == AD5593R_OK && _read(buffer, length) < length) status = AD5593R_ERROR_SHORT_READ;
+    _deselect();
+    return status;
+  }
+
+  AD5593R_Status _write(const byte* data, size_t length) {
+    return AD5593R_write_status(AD5593R_retry_write(_transport, _address, data, length, AD5593R_RETRIES + 1,
+                                                    AD5593R_RETRY_BACKOFF, AD5593R_No_Attempts()));
+  }
+
+  size_t _read(byte* data, size_t length) {
+    return AD5593R_retry_read(_transport, _address, data, length, AD5593R_RETRIES + 1, AD5593R_RETRY_BACKOFF,
+                              AD5593R_No_Attempts());
+  }
+
+  //address of the device while its a0 pin is LOW, see AD5593R.h
+  static const byte _address = 0x10;
+
+  AD5593R_Transport& _transport;
+  int8_t _a0;
+  byte _read_pointer = _ADAC_NULL;
+  byte _GPO_levels = 0;
+};
@@ -0,0 +1,76 @@
+#include "AD5593R_Monitor.h"
+
+AD5593R_Monitor::AD5593R_Monitor(AD5593R& device, callback on_event, void* context) :
+  _device(device), _on_event(on_event), _context(context) {
+  for (int i = 0; i < 8; i++) {
+    _state[i] = AD5593R_MONITOR_INSIDE;
+  }
+  _device._monitor = this;
+}
+
+AD5593R_Monitor::~AD5593R_Monitor() {
+  if (_device._monitor == this) _device._monitor = nullptr;
+}
+
+AD5593R_Status AD5593R_Monitor::set_window(byte channel, uint16_t low, uint16_t high, uint16_t hysteresis) {
+  channel &= 0x07;
+  if (high > 4095 || low > high) return AD5593R_ERROR_RANGE;
+  _low[channel] = low;
+  _high[channel] = high;
+  _hysteresis[channel] = hysteresis;
+  _state[channel] = AD5593R_MONITOR_INSIDE;
+  _windows |= 1 << channel;
+  return AD5593R_OK;
+}
+
+void AD5593R_Monitor::set_edges(byte channel, bool rising, bool falling) {
+  byte bit = 1 << (channel & 0x07);
+  _rising = rising ? _rising | bit : _rising & ~bit;
+  _falling = falling ? _falling | bit : _falling & ~bit;
+  _edges = _rising | _falling;
+  _levels_valid &= ~bit;
+}
+
+void AD5593R_Monitor::disable(byte channel) {
+  byte bit = 1 << (channel & 0x07);
+  _windows &= ~bit;
+  set_edges(channel, 0, 0);
+}
+
+void AD5593R_Monitor::_check_window(byte channel, uint16_t code) {
+  byte state = _state[channel];
+  byte next = state;
+  if (code > _high[channel]) next = AD5593R_MONITOR_ABOVE;
+  else if (code < _low[channel]) next = AD5593R_MONITOR_BELOW;
+  //back inside only once the code has cleared the threshold by the hysteresis
+  else if (state == AD5593R_MONITOR_ABOVE && int(code) + _hysteresis[channel] <= _high[channel]) next = AD5593R_MONITOR_INSIDE;
+  else if (state == AD5593R_MONITOR_BELOW && int(code) >= _low[channel] + _hysteresis[channel]) next = AD5593R_MONITOR_INSIDE;
+  if (next == state) return;
+  _state[channel] = next;
+  _fire(channel, next, code);
+}
+
+void AD5593R_Monitor::_check_edges(byte levels, byte channels) {
+  byte watched = _edges & channels;
+  //only channels read before can have an edge
+  byte changed = (levels ^ _levels) & watched & _levels_valid;
+  _levels = (_levels & ~watched) | (levels & watched);
+  _levels_valid |= watched;
+  for (byte bit = 0; changed; bit++) {
+    if (!(changed & (1 << bit))) continue;
+    changed &= ~(1 << bit);
+    bool level = levels & (1 << bit);
+    if (level && (_rising & (1 << bit))) _fire(bit, AD5593R_MONITOR_RISING, 1);
+    if (!level && (_falling & (1 << bit))) _fire(bit, AD5593R_MONITOR_FALLING, 0);
+  }
+}
+
+void AD5593R_Monitor::_fire(byte channel, byte type, uint16_t code) {
+  AD5593R_Monitor_Event event = {uint32_t(micros()), channel, type, code};
+  if (_on_event) {
+    _on_event(event, _context);
+  }
+  else if (!_queue.push(event)) {
+    _dropped++;
+  }
+}
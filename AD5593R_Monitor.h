@@ -0,0 +1,104 @@
+/*
+Threshold and edge events on ADC and GPI channels.
+
+A monitor attaches to a device and checks every ADC code and GPI level the device reads, inside the
+read itself: read_ADC*(), read_ADCs(), read_ADC_codes() (and so AD5593R_Bus::scan_all()),
+poll_ADC_stream(), AD5593R_Filter results, read_GPIs() and read_mask(). Each check is a compare on the
+12-bit code, and work is only done when a channel changes state:
+  ADC window   a channel is INSIDE until a code goes above its high or below its low threshold, and
+               only goes back INSIDE once a code is hysteresis codes inside the window, so a signal
+               hovering at a threshold does not report every sample
+  GPI edges    RISING and FALLING level changes between two reads, the first read only sets the level
+Events go to the callback given to the constructor, which runs on the task that made the read. Without
+a callback they are queued for read(), from any task.
+ADC codes are compared as returned by read_ADC_code(), after any calibration table; samples of an ADC
+stream are compared raw, as they are stored in the sample buffer.
+*/
+#pragma once
+#include <Arduino.h>
+#include "AD5593R.h"
+#include "AD5593R_Queue.h"
+
+// events held for read(), a power of two
+#ifndef AD5593R_MONITOR_QUEUE_SIZE
+#define AD5593R_MONITOR_QUEUE_SIZE 32
+#endif
+
+enum AD5593R_Monitor_Event_Type {
+  AD5593R_MONITOR_INSIDE,   // an ADC channel came back inside its window
+  AD5593R_MONITOR_BELOW,    // an ADC channel fell below its low threshold
+  AD5593R_MONITOR_ABOVE,    // an ADC channel rose above its high threshold
+  AD5593R_MONITOR_RISING,   // a GPI went from low to high
+  AD5593R_MONITOR_FALLING   // a GPI went from high to low
+};
+
+struct AD5593R_Monitor_Event {
+  uint32_t time;    // micros() when the read was checked
+  byte channel;
+  byte type;        // AD5593R_Monitor_Event_Type
+  uint16_t code;    // the ADC code that caused the event, the new level for a GPI
+};
+
+class AD5593R_Monitor {
+public:
+  typedef void (*callback)(const AD5593R_Monitor_Event& event, void* context);
+
+  // Attaches to device, replacing any monitor attached before. Events are passed to on_event, or
+  // queued if it is nullptr
+  AD5593R_Monitor(AD5593R& device, callback on_event = nullptr, void* context = nullptr);
+  ~AD5593R_Monitor();
+
+  // Window of an ADC channel in codes, the channel starts INSIDE.
+  // Returns AD5593R_ERROR_RANGE if high > 4095 or low > high
+  AD5593R_Status set_window(byte channel, uint16_t low, uint16_t high, uint16_t hysteresis = 0);
+
+  // reports the rising and/or falling edges of a GPI channel
+  void set_edges(byte channel, bool rising, bool falling);
+
+  // stops checking a channel
+  void disable(byte channel);
+
+  // AD5593R_MONITOR_INSIDE, _BELOW or _ABOVE, the last state reported for an ADC channel
+  byte state(byte channel) const { return _state[channel & 0x07]; }
+
+  // takes the oldest queued event into event, returns 0 if there is none
+  bool read(AD5593R_Monitor_Event& event) { return _queue.pop(event); }
+
+  // events lost because the queue was full
+  unsigned long dropped() const { return _dropped; }
+
+private:
+  friend class AD5593R;
+  friend class AD5593R_Filter;
+
+  // called by the device with every ADC code and GPI read
+  void _ADC(byte channel, uint16_t code) {
+    if (_windows & (1 << channel)) _check_window(channel, code);
+  }
+  void _GPIs(byte levels, byte channels) {
+    if (_edges & channels) _check_edges(levels, channels);
+  }
+
+  void _check_window(byte channel, uint16_t code);
+  void _check_edges(byte levels, byte channels);
+  void _fire(byte channel, byte type, uint16_t code);
+
+  AD5593R& _device;
+  callback _on_event;
+  void* _context;
+
+  byte _windows = 0;          // channels with a window
+  uint16_t _low[8];
+  uint16_t _high[8];
+  uint16_t _hysteresis[8];
+  byte _state[8];
+
+  byte _edges = 0;            // channels with an edge reported
+  byte _rising = 0;
+  byte _falling = 0;
+  byte _levels = 0;           // last level of each GPI
+  byte _levels_valid = 0;     // channels read at least once
+
+  AD5593R_Queue<AD5593R_Monitor_Event, AD5593R_MONITOR_QUEUE_SIZE> _queue;
+  unsigned long _dropped = 0;
+};
@@ -0,0 +1,86 @@
+/*
+Bounded lock-free queue used to hand work between tasks, any number of tasks may push and pop.
+
+The queue is an array of N cells (N a power of two) that never allocates. Each cell carries a
+sequence number telling producers and consumers whose turn it is, so push() and pop() only need
+one compare-and-swap each and never block: push() fails when the queue is full, pop() when it is empty.
+*/
+#pragma once
+#include <Arduino.h>
+
+template <typename T, size_t N>
+class AD5593R_Queue {
+public:
+  static const size_t capacity = N;
+
+  AD5593R_Queue() : _enqueue_position(0), _dequeue_position(0) {
+    for (size_t i = 0; i < N; i++) {
+      _cells[i].sequence = i;
+    }
+  }
+
+  // adds value to the queue, returns 0 if the queue is full
+  bool push(const T& value) {
+    size_t position = __atomic_load_n(&_enqueue_position, __ATOMIC_RELAXED);
+    for (;;) {
+      _cell& cell = _cells[position & (N - 1)];
+      size_t sequence = __atomic_load_n(&cell.sequence, __ATOMIC_ACQUIRE);
+      long difference = long(sequence) - long(position);
+      if (difference == 0) {
+        if (__atomic_compare_exchange_n(&_enqueue_position, &position, position + 1, true,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+          cell.value = value;
+          __atomic_store_n(&cell.sequence, position + 1, __ATOMIC_RELEASE);
+          return 1;
+        }
+      }
+      else if (difference < 0) {
+        return 0;
+      }
+      else {
+        position = __atomic_load_n(&_enqueue_position, __ATOMIC_RELAXED);
+      }
+    }
+  }
+
+  // removes the oldest value from the queue into value, returns 0 if the queue is empty
+  bool pop(T& value) {
+    size_t position = __atomic_load_n(&_dequeue_position, __ATOMIC_RELAXED);
+    for (;;) {
+      _cell& cell = _cells[position & (N - 1)];
+      size_t sequence = __atomic_load_n(&cell.sequence, __ATOMIC_ACQUIRE);
+      long difference = long(sequence) - long(position + 1);
+      if (difference == 0) {
+        if (__atomic_compare_exchange_n(&_dequeue_position, &position, position + 1, true,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+          value = cell.value;
+          __atomic_store_n(&cell.sequence, position + N, __ATOMIC_RELEASE);
+          return 1;
+        }
+      }
+      else if (difference < 0) {
+        return 0;
+      }
+      else {
+        position = __atomic_load_n(&_dequeue_position, __ATOMIC_RELAXED);
+      }
+    }
+  }
+
+  // number of values in the queue, only exact while no other task pushes or pops
+  size_t size() const {
+    return __atomic_load_n(&_enqueue_position, __ATOMIC_ACQUIRE) - __atomic_load_n(&_dequeue_position, __ATOMIC_ACQUIRE);
+  }
+
+private:
+  static_assert((N & (N - 1)) == 0, "AD5593R_Queue size must be a power of two");
+
+  struct _cell {
+    size_t sequence;
+    T value;
+  };
+
+  _cell _cells[N];
+  size_t _enqueue_position;
+  size_t _dequeue_position;
+};
@@ -0,0 +1,54 @@
+/*
+Register map of the AD5593R, shared by the driver and the host simulator.
+Refer to the data sheet linked in AD5593R.h for the meaning of each register.
+*/
+#pragma once
+
+//Definitions
+#define _ADAC_NULL           0b00000000
+#define _ADAC_ADC_SEQUENCE   0b00000010 // ADC sequence register - Selects ADCs for conversion
+#define _ADAC_GP_CONTROL     0b00000011 // General-purpose control register - DAC and ADC control register
+#define _ADAC_ADC_CONFIG     0b00000100 // ADC pin configuration - Selects which pins are ADC inputs
+#define _ADAC_DAC_CONFIG     0b00000101 // DAC pin configuration - Selects which pins are DAC outputs
+#define _ADAC_PULL_DOWN      0b00000110 // Pull-down configuration - Selects which pins have an 85 kO pull-down resistor to GND
+#define _ADAC_LDAC_MODE      0b00000111 // LDAC mode - Selects the operation of the load DAC
+#define _ADAC_GPIO_WR_CONFIG 0b00001000 // GPIO write configuration - Selects which pins are general-purpose outputs
+#define _ADAC_GPIO_WR_DATA   0b00001001 // GPIO write data - Writes data to general-purpose outputs
+#define _ADAC_GPIO_RD_CONFIG 0b00001010 // GPIO read configuration - Selects which pins are general-purpose inputs
+#define _ADAC_POWER_REF_CTRL 0b00001011 // Power-down/reference control - Powers down the DACs and enables/disables the reference
+#define _ADAC_OPEN_DRAIN_CFG 0b00001100 // Open-drain configuration - Selects open-drain or push-pull for general-purpose outputs
+#define _ADAC_THREE_STATE    0b00001101 // Three-state pins - Selects which pins are three-stated
+#define _ADAC_RESERVED       0b00001110 // Reserved
+#define _ADAC_SOFT_RESET     0b00001111 // Software reset - Resets the AD5593R
+
+/**
+ * @name     ADAC Configuration Data Bytes
+ ******************************************************************************/
+ ///@{
+ //write into MSB after _ADAC_POWER_REF_CTRL command to enable VREF
+#define _ADAC_VREF_ON     0b00000010
+#define _ADAC_SEQUENCE_ON 0b00000010
+ //write into MSB of _ADAC_ADC_SEQUENCE to add the temperature indicator to the sequence
+#define _ADAC_SEQUENCE_TEMP 0b00000001
+ //LSB bits of _ADAC_GP_CONTROL selecting the 0-2xVref ranges
+#define _ADAC_ADC_RANGE_2X 0b00100000
+#define _ADAC_DAC_RANGE_2X 0b00010000
+ //data written to _ADAC_LDAC_MODE
+#define _ADAC_LDAC_DIRECT 0b00000000 // input registers are copied to the DACs immediately
+#define _ADAC_LDAC_HOLD   0b00000001 // input registers are held until _ADAC_LDAC_LOAD
+#define _ADAC_LDAC_LOAD   0b00000010 // copies all input registers to the DACs, then returns to _ADAC_LDAC_DIRECT
+ //data written to _ADAC_SOFT_RESET to reset the device
+#define _ADAC_RESET_MSBS  0x0D
+#define _ADAC_RESET_LSBS  0xAC
+
+
+
+/**
+ * @name   ADAC Write / Read Pointer Bytes
+******************************************************************************/
+///@{
+#define _ADAC_DAC_WRITE       0b00010000
+#define _ADAC_ADC_READ        0b01000000
+#define _ADAC_DAC_READ        0b01010000
+#define _ADAC_GPIO_READ       0b01100000
+#define _ADAC_REG_READ        0b01110000
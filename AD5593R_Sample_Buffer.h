@@ -0,0 +1,69 @@
+/*
+Fixed-size ring buffer of raw ADC results, filled by the streaming mode of the AD5593R class.
+
+Each entry is the 16 bit word returned by the chip: bits 12-15 hold the channel the sample
+was converted from (8 is the temperature indicator) and bits 0-11 the 12-bit code.
+The buffer never allocates, its capacity is set at compile time with AD5593R_SAMPLE_BUFFER_SIZE,
+which must be a power of two. One task may push while another drains.
+*/
+#pragma once
+#include <Arduino.h>
+
+#ifndef AD5593R_SAMPLE_BUFFER_SIZE
+#define AD5593R_SAMPLE_BUFFER_SIZE 256
+#endif
+
+class AD5593R_Sample_Buffer {
+public:
+  static const size_t capacity = AD5593R_SAMPLE_BUFFER_SIZE;
+
+  AD5593R_Sample_Buffer() : _head(0), _tail(0) {}
+
+  // number of samples waiting to be read
+  size_t size() const {
+    return __atomic_load_n(&_head, __ATOMIC_ACQUIRE) - __atomic_load_n(&_tail, __ATOMIC_ACQUIRE);
+  }
+
+  // number of samples that can be pushed before the buffer is full
+  size_t space() const { return capacity - size(); }
+
+  // adds a sample, returns 0 if the buffer is full
+  bool push(uint16_t sample) {
+    size_t head = __atomic_load_n(&_head, __ATOMIC_RELAXED);
+    if (head - __atomic_load_n(&_tail, __ATOMIC_ACQUIRE) >= capacity) return 0;
+    _samples[head & (capacity - 1)] = sample;
+    __atomic_store_n(&_head, head + 1, __ATOMIC_RELEASE);
+    return 1;
+  }
+
+  // moves up to max_samples of the oldest samples into out, returns the number moved
+  size_t read(uint16_t* out, size_t max_samples) {
+    size_t tail = __atomic_load_n(&_tail, __ATOMIC_RELAXED);
+    size_t available = __atomic_load_n(&_head, __ATOMIC_ACQUIRE) - tail;
+    if (max_samples > available) max_samples = available;
+    for (size_t i = 0; i < max_samples; i++) {
+      out[i] = _samples[(tail + i) & (capacity - 1)];
+    }
+    __atomic_store_n(&_tail, tail + max_samples, __ATOMIC_RELEASE);
+    return max_samples;
+  }
+
+  // drops every sample in the buffer
+  void clear() { __atomic_store_n(&_tail, __atomic_load_n(&_head, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE); }
+
+  // channel a sample was converted from, 8 is the temperature indicator
+  static byte channel(uint16_t sample) { return sample >> 12; }
+
+  // 12-bit code of a sample
+  static uint16_t code(uint16_t sample) { return sample & 0x0fff; }
+
+private:
+  static_assert((AD5593R_SAMPLE_BUFFER_SIZE & (AD5593R_SAMPLE_BUFFER_SIZE - 1)) == 0,
+                "AD5593R_SAMPLE_BUFFER_SIZE must be a power of two");
+
+  uint16_t _samples[AD5593R_SAMPLE_BUFFER_SIZE];
+
+  // free running counters, the index into _samples is the counter modulo the capacity
+  size_t _head;
+  size_t _tail;
+};
@@ -0,0 +1,100 @@
+#include "AD5593R_Scheduler.h"
+
+AD5593R_Scheduler::AD5593R_Scheduler(AD5593R& device) : _device(device) {
+  reset_stats();
+}
+
+AD5593R_Status AD5593R_Scheduler::set_period(byte channel, uint32_t period) {
+  if (channel > 7 || !_device.config.ADCs[channel]) return AD5593R_ERROR_ROLE;
+  if (period == 0) return AD5593R_ERROR_RANGE;
+  _period[channel] = period;
+  _next[channel] = uint32_t(micros());
+  _channels |= 1 << channel;
+  return AD5593R_OK;
+}
+
+void AD5593R_Scheduler::disable(byte channel) {
+  _channels &= ~(1 << (channel & 0x07));
+}
+
+void AD5593R_Scheduler::restart() {
+  uint32_t now = uint32_t(micros());
+  for (int i = 0; i < 8; i++) {
+    _next[i] = now;
+  }
+}
+
+uint32_t AD5593R_Scheduler::next_deadline() const {
+  uint32_t now = uint32_t(micros());
+  uint32_t earliest = now;
+  int32_t shortest = INT32_MAX;
+  for (int i = 0; i < 8; i++) {
+    if (!(_channels & (1 << i))) continue;
+    int32_t wait = int32_t(_next[i] - now);
+    if (wait < shortest) {
+      shortest = wait;
+      earliest = _next[i];
+    }
+  }
+  return earliest;
+}
+
+int AD5593R_Scheduler::poll() {
+  if (_channels == 0) return 0;
+  uint32_t now = uint32_t(micros());
+  byte due = 0;
+  uint32_t shortest = UINT32_MAX;
+  for (int i = 0; i < 8; i++) {
+    if (!(_channels & (1 << i)) || int32_t(now - _next[i]) < 0) continue;
+    due |= 1 << i;
+    if (_period[i] < shortest) shortest = _period[i];
+  }
+  if (due == 0) return 0;
+
+  //channels due before the next scan of the fastest due channel are taken now
+  byte scan = due;
+  for (int i = 0; i < 8; i++) {
+    if ((_channels & ~due) & (1 << i) && int32_t(_next[i] - now) < int32_t(shortest)) scan |= 1 << i;
+  }
+
+  uint16_t codes[8];
+  byte read = _device.read_ADC_codes(scan, codes);
+  _stats.scans++;
+  if (read != scan) _stats.errors++;
+
+  int queued = 0;
+  for (byte i = 0; i < 8; i++) {
+    if (!(scan & (1 << i))) continue;
+    int32_t late = int32_t(now - _next[i]);
+    //whole periods that have passed are skipped, the grid stays where it was
+    if (late >= int32_t(_period[i])) {
+      uint32_t missed = uint32_t(late) / _period[i];
+      _stats.missed[i] += missed;
+      _next[i] += missed * _period[i];
+      late -= missed * _period[i];
+    }
+    _next[i] += _period[i];
+    if (late > 0 && uint32_t(late) > _stats.max_late) _stats.max_late = late;
+    if (!(read & (1 << i))) continue;
+
+    AD5593R_Timed_Sample sample = {now, i, codes[i]};
+    if (!_queue.push(sample)) {
+      _stats.dropped++;
+      continue;
+    }
+    _stats.samples++;
+    queued++;
+  }
+  return queued;
+}
+
+void AD5593R_Scheduler::reset_stats() {
+  _stats.scans = 0;
+  _stats.samples = 0;
+  _stats.errors = 0;
+  _stats.dropped = 0;
+  for (int i = 0; i < 8; i++) {
+    _stats.missed[i] = 0;
+  }
+  _stats.max_late = 0;
+}
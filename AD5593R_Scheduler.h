@@ -0,0 +1,76 @@
+/*
+Deadline-driven sampling of ADC channels at their own rates.
+
+Each channel gets a sample period, e.g. channel 0 every 200 us (5 kHz) and channels 4-7 every 10 ms
+(100 Hz). poll() finds the channels whose deadline has passed and converts them in one sequenced
+scan (read_ADC_codes() with a channel mask). Channels that would come due before the next scan
+anyway (their deadline is less than the shortest period of the due channels away) are added to it,
+so slow channels ride along with fast scans instead of costing transactions of their own.
+
+Deadlines are kept on a fixed grid per channel, start + n * period, so an early or late sample
+does not shift the ones after it. A deadline passed by a whole period or more is missed: it is
+skipped and counted. Every sample is stamped with the micros() at the start of its scan and
+queued for read(), which may be called from another task.
+*/
+#pragma once
+#include <Arduino.h>
+#include "AD5593R.h"
+#include "AD5593R_Queue.h"
+
+// samples held for read(), a power of two
+#ifndef AD5593R_SCHEDULER_QUEUE_SIZE
+#define AD5593R_SCHEDULER_QUEUE_SIZE 64
+#endif
+
+struct AD5593R_Timed_Sample {
+  uint32_t time;    // micros() when the scan started
+  byte channel;
+  uint16_t code;
+};
+
+struct AD5593R_Scheduler_Stats {
+  unsigned long scans;
+  unsigned long samples;
+  unsigned long errors;         // scans that failed, their deadlines are still used up
+  unsigned long dropped;        // samples lost because the queue was full
+  unsigned long missed[8];      // deadlines skipped per channel
+  uint32_t max_late;            // us, latest a sample was taken after its deadline
+};
+
+class AD5593R_Scheduler {
+public:
+  AD5593R_Scheduler(AD5593R& device);
+
+  // Samples an ADC channel every period us, starting at the next poll().
+  // Returns AD5593R_ERROR_ROLE if the channel is not an ADC, AD5593R_ERROR_RANGE if period is 0
+  AD5593R_Status set_period(byte channel, uint32_t period);
+
+  // stops sampling a channel
+  void disable(byte channel);
+
+  // Aligns the deadlines of every channel to now, so channels with periods that are multiples of
+  // each other always share scans
+  void restart();
+
+  // Runs a scan if a deadline has passed, returns the number of samples queued
+  int poll();
+
+  // micros() of the earliest deadline, to sleep until
+  uint32_t next_deadline() const;
+
+  // takes the oldest sample into sample, returns 0 if there is none
+  bool read(AD5593R_Timed_Sample& sample) { return _queue.pop(sample); }
+
+  void get_stats(AD5593R_Scheduler_Stats* stats) const { *stats = _stats; }
+  void reset_stats();
+
+private:
+  AD5593R& _device;
+
+  byte _channels = 0;     // channels being sampled
+  uint32_t _period[8];
+  uint32_t _next[8];      // deadline of the next sample
+
+  AD5593R_Queue<AD5593R_Timed_Sample, AD5593R_SCHEDULER_QUEUE_SIZE> _queue;
+  AD5593R_Scheduler_Stats _stats;
+};
@@ -0,0 +1,67 @@
+/*
+Sequence lock: one writer publishes complete copies of a value, any number of readers take
+consistent copies of it, and neither side ever waits for the other.
+
+The writer makes the sequence number odd, copies the value in, and makes it even again. A reader
+copies the value between two reads of the sequence number and keeps the copy if the number was even
+and did not change, otherwise it tries again. The value is moved in 32-bit words with atomic
+accesses, so a reader racing the writer sees a torn copy (and discards it) but never undefined behavior.
+
+A reader that keeps losing the race, e.g. one that preempts the writer on a single core, gives up
+after AD5593R_SEQLOCK_RETRIES tries instead of spinning, and can try again later.
+*/
+#pragma once
+#include <Arduino.h>
+#include <string.h>
+
+#ifndef AD5593R_SEQLOCK_RETRIES
+#define AD5593R_SEQLOCK_RETRIES 16
+#endif
+
+template <typename T>
+class AD5593R_Seqlock {
+public:
+  // publishes value, from a single writer
+  void write(const T& value) {
+    uint32_t words[_num_of_words];
+    words[_num_of_words - 1] = 0;
+    memcpy(words, &value, sizeof(T));
+    uint32_t sequence = _sequence;
+    __atomic_store_n(&_sequence, sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    for (size_t i = 0; i < _num_of_words; i++) {
+      __atomic_store_n(&_words[i], words[i], __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&_sequence, sequence + 2, __ATOMIC_RELEASE);
+  }
+
+  // Copies the last published value into value, from any task or core.
+  // Returns its version (the number of writes so far), 0 if nothing was published or no consistent copy was made
+  uint32_t read(T& value) const {
+    uint32_t words[_num_of_words];
+    for (int attempt = 0; attempt < AD5593R_SEQLOCK_RETRIES; attempt++) {
+      uint32_t before = __atomic_load_n(&_sequence, __ATOMIC_ACQUIRE);
+      if (before & 1) continue;
+      for (size_t i = 0; i < _num_of_words; i++) {
+        words[i] = __atomic_load_n(&_words[i], __ATOMIC_RELAXED);
+      }
+      __atomic_thread_fence(__ATOMIC_ACQUIRE);
+      if (__atomic_load_n(&_sequence, __ATOMIC_RELAXED) != before) continue;
+      if (before == 0) return 0;
+      memcpy(&value, words, sizeof(T));
+      return before / 2;
+    }
+    return 0;
+  }
+
+  // number of writes so far
+  uint32_t version() const {
+    return __atomic_load_n(&_sequence, __ATOMIC_ACQUIRE) / 2;
+  }
+
+private:
+  static const size_t _num_of_words = (sizeof(T) + 3) / 4;
+
+  uint32_t _sequence = 0;
+  uint32_t _words[_num_of_words];
+};
@@ -0,0 +1,50 @@
+#include "AD5593R_State.h"
+#include "AD5593R_Capture.h"
+
+static byte* put16(byte* p, uint16_t value) {
+  p[0] = value & 0xff;
+  p[1] = value >> 8;
+  return p + 2;
+}
+
+static uint16_t get16(const byte* p) {
+  return p[0] | (uint16_t(p[1]) << 8);
+}
+
+size_t AD5593R_State::serialize(byte* buffer) const {
+  byte* p = buffer;
+  *p++ = 0xAD;
+  *p++ = 0x59;
+  *p++ = AD5593R_STATE_VERSION;
+  for (int i = 0; i < 16; i++) {
+    p = put16(p, registers[i]);
+  }
+  p = put16(p, valid);
+  for (int i = 0; i < 8; i++) {
+    p = put16(p, DAC_codes[i]);
+  }
+  p = put16(p, Vref_uV & 0xffff);
+  p = put16(p, Vref_uV >> 16);
+  *p++ = flags;
+  put16(p, AD5593R_Capture::crc16(buffer, p - buffer));
+  return AD5593R_STATE_SIZE;
+}
+
+bool AD5593R_State::deserialize(const byte* buffer, size_t length) {
+  if (length < AD5593R_STATE_SIZE) return 0;
+  if (buffer[0] != 0xAD || buffer[1] != 0x59 || buffer[2] != AD5593R_STATE_VERSION) return 0;
+  if (AD5593R_Capture::crc16(buffer, AD5593R_STATE_SIZE - 2) != get16(buffer + AD5593R_STATE_SIZE - 2)) return 0;
+  const byte* p = buffer + 3;
+  for (int i = 0; i < 16; i++, p += 2) {
+    registers[i] = get16(p);
+  }
+  valid = get16(p);
+  p += 2;
+  for (int i = 0; i < 8; i++, p += 2) {
+    DAC_codes[i] = get16(p);
+  }
+  Vref_uV = get16(p) | (uint32_t(get16(p + 2)) << 16);
+  p += 4;
+  flags = *p;
+  return 1;
+}
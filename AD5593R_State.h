@@ -0,0 +1,41 @@
+/*
+Device state for a warm start, see AD5593R::save_state() and AD5593R::restore_state().
+
+The state holds what the chip loses in a brownout or a reset: the control registers, the DAC codes,
+and the reference and ranges the driver converts with. serialize() writes it in a fixed little-endian
+layout with a CRC, so it can be kept across a reset of the microcontroller (EEPROM, NVS, RTC memory):
+  0   2   0xAD 0x59
+  2   1   version, AD5593R_STATE_VERSION
+  3   32  registers[16]
+  35  2   valid
+  37  16  DAC_codes[8]
+  53  4   Vref_uV
+  57  1   flags
+  58  2   CRC-16/CCITT-FALSE of bytes 0-57, as in AD5593R_Capture
+*/
+#pragma once
+#include <Arduino.h>
+
+#define AD5593R_STATE_VERSION 1
+// bytes written by serialize()
+#define AD5593R_STATE_SIZE 60
+
+// flags of a state
+#define AD5593R_STATE_ADC_2X       0x01
+#define AD5593R_STATE_DAC_2X       0x02
+#define AD5593R_STATE_TEMPERATURE  0x04  // the temperature indicator is in the ADC sequence
+
+struct AD5593R_State {
+  uint16_t registers[16];   // control registers as last written
+  uint16_t valid;           // bit n is set if registers[n] is known
+  uint16_t DAC_codes[8];    // last code requested on each DAC channel, before any calibration table
+  uint32_t Vref_uV;         // reference voltage in microvolts, 0 if none is specified
+  byte flags;
+
+  // writes the state to buffer, which must hold AD5593R_STATE_SIZE bytes, and returns AD5593R_STATE_SIZE
+  size_t serialize(byte* buffer) const;
+
+  // reads a state written by serialize(), returns 0 and leaves the state as it was if length is short
+  // or the header or CRC do not match
+  bool deserialize(const byte* buffer, size_t length);
+};
@@ -0,0 +1,86 @@
+#include "AD5593R_Stats.h"
+#include <string.h>
+
+#ifdef AD5593R_STATS
+
+static const char* const _operation_names[AD5593R_NUM_OF_OPERATIONS] = {
+  "write_DAC", "write_DACs", "read_ADC", "read_ADCs", "ADC stream", "read_GPIs", "write_GPOs", "configure", "other"
+};
+
+uint32_t AD5593R_Operation_Stats::percentile(byte percent) const {
+  if (calls == 0) return 0;
+  //the first bucket that reaches the requested share of the calls
+  uint32_t target = (uint64_t(calls) * percent + 99) / 100;
+  uint32_t count = 0;
+  for (byte i = 0; i < AD5593R_STATS_BUCKETS; i++) {
+    count += histogram[i];
+    if (count >= target) {
+      uint32_t bound = (uint32_t(1) << i) - 1;
+      return (i == AD5593R_STATS_BUCKETS - 1 || bound > max_time) ? max_time : bound;
+    }
+  }
+  return max_time;
+}
+
+void AD5593R_Stats::clear() {
+  memset(operations, 0, sizeof(operations));
+}
+
+void AD5593R_Stats::record_call(byte operation, uint32_t time) {
+  AD5593R_Operation_Stats& stats = operations[operation];
+  stats.calls++;
+  stats.total_time += time;
+  if (time > stats.max_time) stats.max_time = time;
+  stats.histogram[bucket(time)]++;
+}
+
+void AD5593R_Stats::record_transaction(byte operation, size_t bytes_written, size_t bytes_read, bool error) {
+  AD5593R_Operation_Stats& stats = operations[operation];
+  stats.transactions++;
+  stats.bytes_written += bytes_written;
+  stats.bytes_read += bytes_read;
+  if (error) stats.errors++;
+}
+
+byte AD5593R_Stats::bucket(uint32_t time) {
+  //the number of significant bits, i.e. floor(log2(time)) + 1
+  byte bits = 0;
+  while (time != 0 && bits < AD5593R_STATS_BUCKETS - 1) {
+    time >>= 1;
+    bits++;
+  }
+  return bits;
+}
+
+void AD5593R_Stats::print(Print& out) const {
+  for (byte i = 0; i < AD5593R_NUM_OF_OPERATIONS; i++) {
+    const AD5593R_Operation_Stats& stats = operations[i];
+    if (stats.calls == 0 && stats.transactions == 0) continue;
+    out.print(_operation_names[i]);
+    out.print(": ");
+    out.print((unsigned long)stats.calls);
+    out.print(" calls, ");
+    out.print((unsigned long)stats.transactions);
+    out.print(" transactions, ");
+    out.print((unsigned long)stats.bytes_written);
+    out.print(" bytes written, ");
+    out.print((unsigned long)stats.bytes_read);
+    out.print(" bytes read, ");
+    out.print((unsigned long)stats.errors);
+    out.print(" errors");
+    if (stats.calls > 0) {
+      out.print(", mean ");
+      out.print((unsigned long)(stats.total_time / stats.calls));
+      out.print(" us, p50 <= ");
+      out.print((unsigned long)stats.percentile(50));
+      out.print(" us, p99 <= ");
+      out.print((unsigned long)stats.percentile(99));
+      out.print(" us, max ");
+      out.print((unsigned long)stats.max_time);
+      out.print(" us");
+    }
+    out.println();
+  }
+}
+
+#endif
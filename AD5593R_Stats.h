@@ -0,0 +1,107 @@
+/*
+Per-operation performance counters and latency histograms.
+
+Define AD5593R_STATS for the whole build (-DAD5593R_STATS) to enable them, otherwise none of this
+is compiled and the driver carries no counters. Each AD5593R object then counts, per operation,
+the calls, bus transactions, bytes sent and received, and I2C errors, and sorts the duration of
+every call into a log2 histogram. Read them with AD5593R::get_stats().
+
+Nested calls are charged to the outermost one, e.g. the transactions of read_ADC_code() inside
+read_ADC() count as a single read_ADC() call. Transactions made outside of the measured calls
+(the Vref and range setters, waveform playback) are counted under AD5593R_OP_OTHER.
+AD5593R_Bus::execute() counts one AD5593R_OP_WRITE_DACS call on each device it writes.
+
+The clock is AD5593R_STATS_CLOCK(), micros() by default, which the host build implements with
+std::chrono::steady_clock. Any function returning a free running uint32_t microsecond count works.
+*/
+#pragma once
+#include <Arduino.h>
+
+#ifdef AD5593R_STATS
+
+#ifndef AD5593R_STATS_CLOCK
+#define AD5593R_STATS_CLOCK() micros()
+#endif
+
+// bucket 0 counts calls shorter than 1 us, bucket n those of 2^(n-1) to 2^n - 1 us,
+// and the last bucket everything from 2^(AD5593R_STATS_BUCKETS - 2) us up
+#define AD5593R_STATS_BUCKETS 16
+
+enum AD5593R_Operation {
+  AD5593R_OP_WRITE_DAC,   // write_DAC(), write_DAC_code(), write_DAC_mV()
+  AD5593R_OP_WRITE_DACS,  // write_DACs(), write_DAC_codes(), AD5593R_Bus::execute()
+  AD5593R_OP_READ_ADC,    // read_ADC(), read_ADC_code(), read_ADC_mV()
+  AD5593R_OP_READ_ADCS,   // read_ADCs(), read_ADC_codes()
+  AD5593R_OP_STREAM,      // start_ADC_stream(), poll_ADC_stream()
+  AD5593R_OP_READ_GPIS,   // read_GPIs()
+  AD5593R_OP_WRITE_GPOS,  // write_GPOs()
+  AD5593R_OP_CONFIGURE,   // configure_pins() and the configure_*() calls
+  AD5593R_OP_OTHER,
+  AD5593R_NUM_OF_OPERATIONS
+};
+
+struct AD5593R_Operation_Stats {
+  uint32_t calls;
+  uint32_t transactions;
+  uint32_t bytes_written;
+  uint32_t bytes_read;
+  uint32_t errors;         // writes that were not acknowledged and short reads
+  uint32_t total_time;     // sum of the call durations in us
+  uint32_t max_time;       // longest call in us
+  uint32_t histogram[AD5593R_STATS_BUCKETS];
+
+  // Upper bound in us of the bucket holding the given percentile (0-100) of the calls, 0 if there were none.
+  // percentile(99) tells how long all but the slowest 1% of the calls took
+  uint32_t percentile(byte percent) const;
+};
+
+struct AD5593R_Stats {
+  AD5593R_Operation_Stats operations[AD5593R_NUM_OF_OPERATIONS];
+
+  void clear();
+
+  // adds a measured call of operation that took time us
+  void record_call(byte operation, uint32_t time);
+
+  // adds a bus transaction made on behalf of operation
+  void record_transaction(byte operation, size_t bytes_written, size_t bytes_read, bool error);
+
+  // returns the histogram bucket of a call that took time us
+  static byte bucket(uint32_t time);
+
+  // prints a line per operation that was used, with its counters and latency percentiles
+  void print(Print& out) const;
+};
+
+// Measures the call it is declared in, unless another measured call is already running on the device.
+// current holds the operation being measured, AD5593R_OP_OTHER when there is none
+class AD5593R_Stats_Scope {
+public:
+  AD5593R_Stats_Scope(AD5593R_Stats& stats, byte& current, byte operation)
+    : _stats(stats), _current(current), _outermost(current == AD5593R_OP_OTHER) {
+    if (!_outermost) return;
+    _current = operation;
+    _start = AD5593R_STATS_CLOCK();
+  }
+
+  ~AD5593R_Stats_Scope() {
+    if (!_outermost) return;
+    _stats.record_call(_current, uint32_t(AD5593R_STATS_CLOCK()) - _start);
+    _current = AD5593R_OP_OTHER;
+  }
+
+private:
+  AD5593R_Stats& _stats;
+  byte& _current;
+  bool _outermost;
+  uint32_t _start = 0;
+};
+
+// used inside AD5593R member functions
+#define AD5593R_STATS_SCOPE(operation) AD5593R_Stats_Scope _stats_scope(_stats, _stats_operation, (operation))
+#define AD5593R_STATS_TRANSACTION(bytes_written, bytes_read, error) \
+  _stats.record_transaction(_stats_operation, (bytes_written), (bytes_read), (error))
+#else
+#define AD5593R_STATS_SCOPE(operation) ((void)0)
+#define AD5593R_STATS_TRANSACTION(bytes_written, bytes_read, error) ((void)0)
+#endif
@@ -0,0 +1,61 @@
+/*
+Status codes and device health.
+
+Calls that can fail return an AD5593R_Status. The first values keep the numbers the driver has
+always returned (1 on success, -1/-2/-3 for configuration errors), so comparing with them still works.
+
+Every bus transaction is checked. A failed transaction is retried up to the retry budget of the
+device, waiting a backoff that doubles on each attempt (see AD5593R::set_retries()). When the budget
+is used up the transaction fails and the failure is counted in the health of the device. A bus error
+or timeout, or SDA found held low, also makes the transport recover the bus; a device that only does
+not answer (NACK, short read) leaves the bus as it is, so other devices sharing it are not disturbed. After AD5593R_OFFLINE_AFTER failures in a row the device is
+taken offline: its calls return AD5593R_ERROR_OFFLINE right away, except for a single attempt every
+AD5593R_OFFLINE_PROBE_MS, and the first successful transaction brings it back online.
+*/
+#pragma once
+#include <Arduino.h>
+
+// failed attempts repeated before a transaction fails, and the first backoff in us
+#ifndef AD5593R_RETRIES
+#define AD5593R_RETRIES 2
+#endif
+#ifndef AD5593R_RETRY_BACKOFF
+#define AD5593R_RETRY_BACKOFF 50
+#endif
+
+// failed transactions in a row that take a device offline
+#ifndef AD5593R_OFFLINE_AFTER
+#define AD5593R_OFFLINE_AFTER 3
+#endif
+
+// time given to the chip to come out of a software reset, in us
+#ifndef AD5593R_RESET_DELAY
+#define AD5593R_RESET_DELAY 250
+#endif
+
+// interval between attempts to reach an offline device
+#ifndef AD5593R_OFFLINE_PROBE_MS
+#define AD5593R_OFFLINE_PROBE_MS 1000
+#endif
+
+enum AD5593R_Status {
+  AD5593R_OK = 1,
+  AD5593R_ERROR_ROLE = -1,        // the channel is not configured for the call
+  AD5593R_ERROR_NO_VREF = -2,     // no reference voltage is specified
+  AD5593R_ERROR_RANGE = -3,       // a value is out of range
+  AD5593R_ERROR_NACK = -4,        // the device did not acknowledge its address or data
+  AD5593R_ERROR_BUS = -5,         // bus error, timeout or lost arbitration
+  AD5593R_ERROR_SHORT_READ = -6,  // the device sent fewer bytes than requested
+  AD5593R_ERROR_OFFLINE = -7,     // the device is offline and was skipped
+  AD5593R_ERROR_VERIFY = -8       // a register read back does not hold the value written
+};
+
+struct AD5593R_Health {
+  bool online;
+  byte failures;               // failed transactions in a row
+  AD5593R_Status last_error;   // status of the last failed transaction
+  uint32_t errors;             // failed transactions
+  uint32_t retries;            // attempts repeated after an error
+  uint32_t recoveries;         // bus recoveries requested
+  unsigned long last_attempt;  // millis() of the last transaction while offline
+};
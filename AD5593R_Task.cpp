@@ -0,0 +1,102 @@
+#include "AD5593R_Task.h"
+
+#if AD5593R_HAS_TASKS
+
+#if !defined(ARDUINO) && defined(__linux__)
+#include <pthread.h>
+#endif
+
+AD5593R_Task::AD5593R_Task() {
+}
+
+AD5593R_Task::~AD5593R_Task() {
+  join();
+}
+
+#ifdef ARDUINO
+
+void AD5593R_Task::_entry(void* task) {
+  AD5593R_Task* self = static_cast<AD5593R_Task*>(task);
+  self->_function(self->_context);
+  //after this no notify() starts using the handle, wait for any that already has before it becomes invalid
+  __atomic_store_n(&self->_handle, nullptr, __ATOMIC_SEQ_CST);
+  while (__atomic_load_n(&self->_notifying, __ATOMIC_SEQ_CST) > 0) {
+    vTaskDelay(1);
+  }
+  xSemaphoreGive(self->_done);
+  vTaskDelete(NULL);
+}
+
+bool AD5593R_Task::start(function task_function, void* context, int core, const char* name) {
+  if (_running) return 0;
+  if (_done == nullptr) _done = xSemaphoreCreateBinary();
+  _function = task_function;
+  _context = context;
+  BaseType_t created = xTaskCreatePinnedToCore(_entry, name, AD5593R_TASK_STACK_SIZE, this, AD5593R_TASK_PRIORITY,
+                                               &_handle, core < 0 ? tskNO_AFFINITY : core);
+  _running = created == pdPASS;
+  return _running;
+}
+
+void AD5593R_Task::join() {
+  if (!_running) return;
+  xSemaphoreTake(_done, portMAX_DELAY);
+  _running = 0;
+}
+
+void AD5593R_Task::notify() {
+  //announced before the handle is read, so a task that is returning waits for the notification to finish
+  __atomic_add_fetch(&_notifying, 1, __ATOMIC_SEQ_CST);
+  TaskHandle_t handle = __atomic_load_n(&_handle, __ATOMIC_SEQ_CST);
+  if (handle != nullptr) xTaskNotifyGive(handle);
+  __atomic_sub_fetch(&_notifying, 1, __ATOMIC_SEQ_CST);
+}
+
+void AD5593R_Task::wait(unsigned long timeout_ms) {
+  ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeout_ms));
+}
+
+#else
+
+bool AD5593R_Task::start(function task_function, void* context, int core, const char* name) {
+  (void)name;
+  if (_running) return 0;
+  _function = task_function;
+  _context = context;
+  _notifications = 0;
+  _thread = std::thread(task_function, context);
+#ifdef __linux__
+  if (core >= 0) {
+    cpu_set_t cores;
+    CPU_ZERO(&cores);
+    CPU_SET(core, &cores);
+    pthread_setaffinity_np(_thread.native_handle(), sizeof(cores), &cores);
+  }
+#else
+  (void)core;
+#endif
+  _running = 1;
+  return 1;
+}
+
+void AD5593R_Task::join() {
+  if (!_running) return;
+  _thread.join();
+  _running = 0;
+}
+
+void AD5593R_Task::notify() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _notifications++;
+  _wake.notify_one();
+}
+
+void AD5593R_Task::wait(unsigned long timeout_ms) {
+  std::unique_lock<std::mutex> lock(_mutex);
+  _wake.wait_for(lock, std::chrono::milliseconds(timeout_ms), [this] { return _notifications > 0; });
+  _notifications = 0;
+}
+
+#endif
+
+#endif
@@ -0,0 +1,82 @@
+/*
+Minimal task wrapper used by the asynchronous parts of the library.
+
+On the ESP32 a task is a FreeRTOS task that can be pinned to a core, in the host build it is a
+std::thread (pinned with the Linux affinity API). Other Arduino targets have no tasks, and
+AD5593R_HAS_TASKS is 0 there.
+*/
+#pragma once
+#include <Arduino.h>
+
+#if defined(ESP32) || !defined(ARDUINO)
+#define AD5593R_HAS_TASKS 1
+#else
+#define AD5593R_HAS_TASKS 0
+#endif
+
+#if AD5593R_HAS_TASKS
+
+#ifndef AD5593R_TASK_STACK_SIZE
+#define AD5593R_TASK_STACK_SIZE 4096
+#endif
+
+#ifndef AD5593R_TASK_PRIORITY
+#define AD5593R_TASK_PRIORITY 5
+#endif
+
+#ifdef ARDUINO
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#else
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif
+
+class AD5593R_Task {
+public:
+  typedef void (*function)(void* context);
+
+  AD5593R_Task();
+
+  // waits for the task to return
+  ~AD5593R_Task();
+
+  // Runs task_function(context) on a new task. core selects the CPU core the task is pinned to,
+  // -1 leaves the choice to the scheduler. Returns 0 if the task could not be created or is already running.
+  bool start(function task_function, void* context, int core = -1, const char* name = "AD5593R");
+
+  // waits until the task function has returned
+  void join();
+
+  bool running() const { return _running; }
+
+  // wakes the task if it is blocked in wait(), a notification sent before wait() is not lost.
+  // Safe to call while the task is returning or after it has returned
+  void notify();
+
+  // called from the task itself, blocks until notify() or until timeout_ms has passed
+  void wait(unsigned long timeout_ms);
+
+private:
+  function _function = nullptr;
+  void* _context = nullptr;
+  bool _running = 0;
+
+#ifdef ARDUINO
+  static void _entry(void* task);
+  // cleared by the task before it deletes itself, notify() never uses a deleted handle
+  TaskHandle_t _handle = nullptr;
+  // notify() calls using _handle, the task waits for them before deleting itself
+  byte _notifying = 0;
+  SemaphoreHandle_t _done = nullptr;
+#else
+  std::thread _thread;
+  std::mutex _mutex;
+  std::condition_variable _wake;
+  unsigned _notifications = 0;
+#endif
+};
+
+#endif
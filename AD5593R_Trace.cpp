@@ -0,0 +1,104 @@
+#include "AD5593R_Trace.h"
+#include "AD5593R_Registers.h"
+
+#if AD5593R_LOG_LEVEL > 0
+AD5593R_Trace AD5593R_trace;
+#endif
+
+static const char* const _event_names[AD5593R_NUM_OF_EVENTS] = {
+  "ERROR! not a DAC",
+  "ERROR! not an ADC",
+  "ERROR! Vref, or max voltage is not defined",
+  "ERROR! out of range",
+  "ERROR! assigned more than once",
+  "ERROR! no channel is a DAC",
+  "ERROR! no channel is an ADC",
+  "ERROR! bus transaction failed, status -",
+  "ERROR! device offline after failed transactions:",
+  "ERROR! no transport left, AD5593R_WIRE_BUSES is",
+  "configured as a",
+  "pins configured",
+  "internal reference",
+  "ADC max voltage x Vref",
+  "DAC max voltage x Vref",
+  "ADC stream started",
+  "ADC stream stopped",
+  "device online",
+  "temperature in sequence",
+  "DAC write",
+  "ADC read"
+};
+
+void AD5593R_Trace::record(byte event, byte channel, uint16_t value) {
+  uint32_t index = __atomic_fetch_add(&_head, 1, __ATOMIC_ACQ_REL);
+  AD5593R_Trace_Entry& entry = _entries[index & (AD5593R_TRACE_SIZE - 1)];
+  entry.time = micros();
+  entry.event = event;
+  entry.channel = channel;
+  entry.value = value;
+#ifdef AD5593R_TRACE_ECHO
+  print(Serial, entry);
+#endif
+}
+
+size_t AD5593R_Trace::read(AD5593R_Trace_Entry* out, size_t max_entries) {
+  uint32_t head = __atomic_load_n(&_head, __ATOMIC_ACQUIRE);
+  uint32_t first = _tail;
+  if (head - first > AD5593R_TRACE_SIZE) first = head - AD5593R_TRACE_SIZE;
+  size_t count = 0;
+  for (uint32_t i = first; i != head && count < max_entries; i++) {
+    out[count++] = _entries[i & (AD5593R_TRACE_SIZE - 1)];
+  }
+  return count;
+}
+
+void AD5593R_Trace::dump(Print& out) {
+  AD5593R_Trace_Entry entries[AD5593R_TRACE_SIZE];
+  size_t count = read(entries, AD5593R_TRACE_SIZE);
+  for (size_t i = 0; i < count; i++) {
+    print(out, entries[i]);
+  }
+  clear();
+}
+
+void AD5593R_Trace::clear() {
+  _tail = __atomic_load_n(&_head, __ATOMIC_ACQUIRE);
+}
+
+uint32_t AD5593R_Trace::overwritten() {
+  uint32_t pending = __atomic_load_n(&_head, __ATOMIC_ACQUIRE) - _tail;
+  return pending > AD5593R_TRACE_SIZE ? pending - AD5593R_TRACE_SIZE : 0;
+}
+
+void AD5593R_Trace::print(Print& out, const AD5593R_Trace_Entry& entry) {
+  out.print((unsigned long)entry.time);
+  out.print(" us ");
+  if (entry.channel != 0xff) {
+    out.print("Channel ");
+    out.print(int(entry.channel));
+    out.print(" ");
+  }
+  out.print(entry.event < AD5593R_NUM_OF_EVENTS ? _event_names[entry.event] : "unknown event");
+  switch (entry.event) {
+    case AD5593R_EVENT_PIN_ROLE:
+      if (entry.value == _ADAC_DAC_CONFIG) out.print(" DAC");
+      else if (entry.value == _ADAC_ADC_CONFIG) out.print(" ADC");
+      else if (entry.value == _ADAC_GPIO_RD_CONFIG) out.print(" GPI");
+      else if (entry.value == _ADAC_GPIO_WR_CONFIG) out.print(" GPO");
+      break;
+    case AD5593R_EVENT_BUS_ERROR:
+      out.print((unsigned int)entry.value);
+      break;
+    case AD5593R_EVENT_ONLINE:
+    case AD5593R_EVENT_NO_VREF:
+    case AD5593R_EVENT_NO_DACS:
+    case AD5593R_EVENT_NO_ADCS:
+    case AD5593R_EVENT_STREAM_STOP:
+      break;
+    default:
+      out.print(" ");
+      out.print((unsigned int)entry.value);
+      break;
+  }
+  out.println();
+}
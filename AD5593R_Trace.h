@@ -0,0 +1,124 @@
+/*
+Compile-time log levels and a binary trace of driver events.
+
+Instead of printing text while it works, the driver records each event as an 8 byte entry
+(timestamp, event, channel, value) in a fixed RAM ring buffer. Recording costs a few
+stores, the entries are only turned into text when AD5593R_trace.dump() is called.
+
+AD5593R_LOG_LEVEL selects what is recorded, anything above it is compiled out entirely:
+  0 nothing (default, the trace buffer does not exist)
+  1 errors
+  2 errors and configuration changes
+  3 everything, including each DAC write and ADC read
+The level must be the same for the library and the sketch, so set it with a build flag
+(-DAD5593R_LOG_LEVEL=2) or change the default below. AD5593R_TRACE_SIZE sets the number
+of entries kept (a power of two, 64 by default).
+
+Defining AD5593R_DEBUG selects level 3 and additionally prints every entry to Serial as it is recorded.
+*/
+#pragma once
+#include <Arduino.h>
+
+#ifdef AD5593R_DEBUG
+#undef AD5593R_LOG_LEVEL
+#define AD5593R_LOG_LEVEL 3
+#define AD5593R_TRACE_ECHO
+#endif
+
+#ifndef AD5593R_LOG_LEVEL
+#define AD5593R_LOG_LEVEL 0
+#endif
+
+#ifndef AD5593R_TRACE_SIZE
+#define AD5593R_TRACE_SIZE 64
+#endif
+
+// events recorded in the trace, channel is 0xff when an event is not tied to a channel
+enum AD5593R_Event {
+  // errors
+  AD5593R_EVENT_NOT_A_DAC,        // channel is not configured as a DAC
+  AD5593R_EVENT_NOT_AN_ADC,       // channel is not configured as an ADC
+  AD5593R_EVENT_NO_VREF,          // no reference voltage is defined
+  AD5593R_EVENT_OUT_OF_RANGE,     // value (millivolts or code) exceeds the range of channel
+  AD5593R_EVENT_DOUBLE_ASSIGNED,  // channel has more than one function in a configuration
+  AD5593R_EVENT_NO_DACS,          // no channel is configured as a DAC
+  AD5593R_EVENT_NO_ADCS,          // no channel is configured as an ADC
+  AD5593R_EVENT_BUS_ERROR,        // a transaction failed after its retries, value is minus its AD5593R_Status
+  AD5593R_EVENT_OFFLINE,          // the device was taken offline after value failed transactions in a row
+  AD5593R_EVENT_NO_TRANSPORT,     // AD5593R_wire_transport() ran out of transports, value is AD5593R_WIRE_BUSES
+  // configuration changes
+  AD5593R_EVENT_PIN_ROLE,         // channel added to the pin configuration register in value
+  AD5593R_EVENT_PINS_CONFIGURED,  // configure_pins(), value holds the DAC mask in its MSBs and the ADC mask in its LSBs
+  AD5593R_EVENT_VREF,             // internal reference enabled (1) or disabled (0)
+  AD5593R_EVENT_ADC_RANGE,        // ADC range set to value x Vref
+  AD5593R_EVENT_DAC_RANGE,        // DAC range set to value x Vref
+  AD5593R_EVENT_STREAM_START,     // ADC stream started on the channel mask in value
+  AD5593R_EVENT_STREAM_STOP,
+  AD5593R_EVENT_ONLINE,           // an offline device answered again
+  AD5593R_EVENT_TEMPERATURE,      // temperature indicator added to (1) or removed from (0) the ADC sequence
+  // data
+  AD5593R_EVENT_DAC_WRITE,        // code value written to channel
+  AD5593R_EVENT_ADC_READ,         // code value read from channel, 8 is the temperature indicator
+  AD5593R_NUM_OF_EVENTS
+};
+
+struct AD5593R_Trace_Entry {
+  uint32_t time;  // micros() when the event was recorded
+  byte event;     // one of AD5593R_Event
+  byte channel;
+  uint16_t value;
+};
+
+class AD5593R_Trace {
+public:
+  // adds an entry, overwriting the oldest one when the buffer is full
+  void record(byte event, byte channel, uint16_t value);
+
+  // copies up to max_entries of the oldest entries into out without removing them, returns the number copied
+  size_t read(AD5593R_Trace_Entry* out, size_t max_entries);
+
+  // prints every entry as text, oldest first, then clears the buffer
+  void dump(Print& out);
+
+  void clear();
+
+  // number of entries overwritten before they were dumped
+  uint32_t overwritten();
+
+  // prints a single entry as text
+  static void print(Print& out, const AD5593R_Trace_Entry& entry);
+
+private:
+  static_assert((AD5593R_TRACE_SIZE & (AD5593R_TRACE_SIZE - 1)) == 0, "AD5593R_TRACE_SIZE must be a power of two");
+
+  AD5593R_Trace_Entry _entries[AD5593R_TRACE_SIZE];
+
+  // free running counters of entries recorded and entries cleared
+  uint32_t _head = 0;
+  uint32_t _tail = 0;
+};
+
+#if AD5593R_LOG_LEVEL > 0
+extern AD5593R_Trace AD5593R_trace;
+#define AD5593R_LOG(event, channel, value) AD5593R_trace.record((event), (channel), (value))
+#else
+#define AD5593R_LOG(event, channel, value) ((void)0)
+#endif
+
+#if AD5593R_LOG_LEVEL >= 1
+#define AD5593R_LOG_ERROR(event, channel, value) AD5593R_LOG(event, channel, value)
+#else
+#define AD5593R_LOG_ERROR(event, channel, value) ((void)0)
+#endif
+
+#if AD5593R_LOG_LEVEL >= 2
+#define AD5593R_LOG_INFO(event, channel, value) AD5593R_LOG(event, channel, value)
+#else
+#define AD5593R_LOG_INFO(event, channel, value) ((void)0)
+#endif
+
+#if AD5593R_LOG_LEVEL >= 3
+#define AD5593R_LOG_TRACE(event, channel, value) AD5593R_LOG(event, channel, value)
+#else
+#define AD5593R_LOG_TRACE(event, channel, value) ((void)0)
+#endif
@@ -0,0 +1,82 @@
+/*
+Bus transactions with retries, shared by AD5593R and AD5593R_Fixed.
+
+AD5593R_retry_write() and AD5593R_retry_read() repeat a failed transaction up to a number of attempts,
+waiting a backoff that doubles on each retry (see AD5593R_Status.h). The caller passes a function that
+sees every attempt, which is where AD5593R counts its statistics and retries; AD5593R_Fixed passes none.
+AD5593R_burst() splits a run of 3 byte register frames into the fewest transactions AD5593R_MAX_TRANSFER
+allows, or one per frame when AD5593R_BURST_WRITES is 0.
+*/
+#pragma once
+#include <Arduino.h>
+#include "AD5593R_Transport.h"
+#include "AD5593R_Status.h"
+
+// observer for callers that do not need to see the attempts
+struct AD5593R_No_Attempts {
+  void operator()(size_t bytes_written, size_t bytes_read, bool error, bool retrying) const {
+    (void)bytes_written;
+    (void)bytes_read;
+    (void)error;
+    (void)retrying;
+  }
+};
+
+// status of a write as returned by Wire.endTransmission()
+inline AD5593R_Status AD5593R_write_status(byte status) {
+  //2 address not acknowledged, 3 data not acknowledged, 4 other error, 5 timeout
+  if (status == 0) return AD5593R_OK;
+  if (status == 2 || status == 3) return AD5593R_ERROR_NACK;
+  return AD5593R_ERROR_BUS;
+}
+
+// Writes data in one transaction, in up to attempts tries. attempt(bytes_written, bytes_read, error, retrying)
+// is called after each try. Returns the Wire status of the last try
+template <class Attempt>
+byte AD5593R_retry_write(AD5593R_Transport& transport, byte address, const byte* data, size_t length,
+                         byte attempts, uint16_t backoff, Attempt attempt) {
+  byte status = 0;
+  for (byte tries = 1; ; tries++) {
+    status = transport.write(address, data, length);
+    //1 means the data did not fit in the Wire buffer, sending it again does not help
+    bool retrying = status != 0 && status != 1 && tries < attempts;
+    attempt(length, size_t(0), status != 0, retrying);
+    if (!retrying) return status;
+    delayMicroseconds(backoff);
+    backoff *= 2;
+  }
+}
+
+// Reads length bytes in one transaction, in up to attempts tries. Returns the number of bytes received
+template <class Attempt>
+size_t AD5593R_retry_read(AD5593R_Transport& transport, byte address, byte* data, size_t length,
+                          byte attempts, uint16_t backoff, Attempt attempt) {
+  size_t received = 0;
+  for (byte tries = 1; ; tries++) {
+    received = transport.read(address, data, length);
+    bool retrying = received < length && tries < attempts;
+    attempt(size_t(0), received, received < length, retrying);
+    if (!retrying) return received;
+    delayMicroseconds(backoff);
+    backoff *= 2;
+  }
+}
+
+// Calls write(offset, chunk) for each transaction the frames in data[0, length) are sent in, offset and
+// chunk in bytes. Every chunk is written, returns AD5593R_OK or the status of the last chunk that failed
+template <class Write>
+AD5593R_Status AD5593R_burst(size_t length, Write write) {
+#if AD5593R_BURST_WRITES
+  const size_t frames_per_write = AD5593R_MAX_TRANSFER / 3;
+#else
+  const size_t frames_per_write = 1;
+#endif
+  AD5593R_Status status = AD5593R_OK;
+  for (size_t offset = 0; offset < length; offset += 3 * frames_per_write) {
+    size_t chunk = length - offset;
+    if (chunk > 3 * frames_per_write) chunk = 3 * frames_per_write;
+    AD5593R_Status chunk_status = write(offset, chunk);
+    if (chunk_status != AD5593R_OK) status = chunk_status;
+  }
+  return status;
+}
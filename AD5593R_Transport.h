@@ -0,0 +1,82 @@
+/*
+Transport interface used by the AD5593R class.
+
+Every bus access of the driver (I2C transactions and the a0 select pin) goes through
+an AD5593R_Transport, so the driver can run on top of the Arduino Wire library
+(see AD5593R_Wire.h) or on top of the simulated chip used by the host build
+(see extras/host/AD5593R_Sim.h).
+
+A transport may be shared by several AD5593R objects on the same bus.
+*/
+#pragma once
+#include <Arduino.h>
+#ifdef ARDUINO
+#include <Wire.h>
+#endif
+
+// largest number of bytes the driver moves in a single transaction,
+// defaults to the size of the Wire buffer of the target
+#ifndef AD5593R_MAX_TRANSFER
+#if defined(I2C_BUFFER_LENGTH)
+#define AD5593R_MAX_TRANSFER I2C_BUFFER_LENGTH
+#elif defined(BUFFER_LENGTH)
+#define AD5593R_MAX_TRANSFER BUFFER_LENGTH
+#else
+#define AD5593R_MAX_TRANSFER 32
+#endif
+#endif
+
+// when set, consecutive register writes are sent as back to back pointer/data frames in one transaction,
+// set to 0 to send every register write as a transaction of its own
+#ifndef AD5593R_BURST_WRITES
+#define AD5593R_BURST_WRITES 1
+#endif
+
+class AD5593R_Transport {
+public:
+  virtual ~AD5593R_Transport() {}
+
+  // prepares the bus, it is safe to call this function more than once
+  virtual void begin() = 0;
+
+  // prepares the given pin to drive the a0 pin of an AD5593R, the pin is left HIGH (not selected)
+  virtual void attach_a0(int pin) = 0;
+
+  // drives the a0 pin of an AD5593R, LOW selects the device (see AD5593R.h)
+  virtual void set_a0(int pin, bool level) = 0;
+
+  // writes length bytes to the device at address in a single transaction,
+  // returns the same status codes as Wire.endTransmission(), 0 on success
+  virtual byte write(byte address, const byte* data, size_t length) = 0;
+
+  // reads length bytes from the device at address in a single transaction,
+  // returns the number of bytes received
+  virtual size_t read(byte address, byte* data, size_t length) = 0;
+
+  // Brings a stuck bus back to idle after failed transactions, e.g. by clocking SCL until a device
+  // releases SDA and initializing the controller again. The default does nothing
+  virtual void recover() {}
+
+  // Pins of the bus, for transports whose recover() drives the lines itself. The default ignores them
+  virtual void set_pins(int sda, int scl) {}
+
+  // returns 1 if SDA is held low while the bus should be idle, 0 if it is not or the transport cannot tell
+  virtual bool stuck() { return 0; }
+};
+
+// transport used by AD5593R objects constructed without one,
+// on Arduino targets this is the global Wire object (see AD5593R_Wire.cpp)
+AD5593R_Transport& AD5593R_default_transport();
+
+#ifdef ARDUINO
+// number of I2C controllers AD5593R_wire_transport() can hand out transports for, Wire included
+#ifndef AD5593R_WIRE_BUSES
+#define AD5593R_WIRE_BUSES 2
+#endif
+
+// Transport on the given I2C controller, e.g. Wire1 on the ESP32. Every call with the same controller
+// returns the same transport, so devices on one bus share it. Wire returns AD5593R_default_transport().
+// Once AD5593R_WIRE_BUSES controllers are in use, another one gets a transport on which every transaction
+// fails with AD5593R_ERROR_BUS, and AD5593R_EVENT_NO_TRANSPORT is logged: raise AD5593R_WIRE_BUSES
+AD5593R_Transport& AD5593R_wire_transport(TwoWire& wire);
+#endif
@@ -0,0 +1,141 @@
+#include "AD5593R_Waveform.h"
+#include <math.h>
+
+AD5593R_Waveform::AD5593R_Waveform(AD5593R& device, byte* table, size_t table_size) :
+  _device(device), _table(table), _table_size(table_size) {
+}
+
+bool AD5593R_Waveform::set_length(byte channels, size_t samples) {
+  size_t num_of_channels = 0;
+  for (int i = 0; i < 8; i++) {
+    if ((channels & (1 << i)) == 0) continue;
+    if (_device.config.DACs[i] == 0) return 0;
+    num_of_channels++;
+  }
+  if (num_of_channels == 0 || samples == 0 || 3 * num_of_channels * samples > _table_size) return 0;
+
+  stop();
+  _channels = channels;
+  _samples = samples;
+  _row_size = 3 * num_of_channels;
+  for (size_t index = 0; index < samples; index++) {
+    byte* frame = _row(index);
+    for (int i = 0; i < 8; i++) {
+      if ((channels & (1 << i)) == 0) continue;
+      AD5593R::encode_DAC_frame(i, _device._DAC_code(i, 0), frame);
+      frame += 3;
+    }
+  }
+  return 1;
+}
+
+int AD5593R_Waveform::_offset(byte channel) {
+  if (channel > 7 || (_channels & (1 << channel)) == 0) return -1;
+  int offset = 0;
+  for (int i = 0; i < channel; i++) {
+    if (_channels & (1 << i)) offset += 3;
+  }
+  return offset;
+}
+
+void AD5593R_Waveform::set_sample(byte channel, size_t index, uint16_t code) {
+  int offset = _offset(channel);
+  if (offset < 0 || index >= _samples) return;
+  if (code > 4095) code = 4095;
+  AD5593R::encode_DAC_frame(channel, _device._DAC_code(channel, code), _row(index) + offset);
+}
+
+void AD5593R_Waveform::set_samples(byte channel, const uint16_t* codes) {
+  for (size_t i = 0; i < _samples; i++) {
+    set_sample(channel, i, codes[i]);
+  }
+}
+
+void AD5593R_Waveform::set_sine(byte channel, uint16_t offset, uint16_t amplitude, float phase) {
+  const float two_pi = 6.28318530718f;
+  for (size_t i = 0; i < _samples; i++) {
+    float angle = two_pi * i / _samples + phase * two_pi / 360;
+    long code = lroundf(offset + amplitude * sinf(angle));
+    if (code < 0) code = 0;
+    if (code > 4095) code = 4095;
+    set_sample(channel, i, uint16_t(code));
+  }
+}
+
+void AD5593R_Waveform::set_ramp(byte channel, uint16_t start, uint16_t end) {
+  for (size_t i = 0; i < _samples; i++) {
+    long step = _samples > 1 ? (long(end) - long(start)) * long(i) / long(_samples - 1) : 0;
+    set_sample(channel, i, uint16_t(start + step));
+  }
+}
+
+bool AD5593R_Waveform::start(uint32_t sample_rate) {
+  if (_samples == 0 || sample_rate == 0 || 1000000UL / sample_rate == 0) return 0;
+  _rate = sample_rate;
+  _period = 1000000UL / sample_rate;
+  _remainder = 1000000UL % sample_rate;
+  _error = 0;
+  _position = 0;
+  _next = micros();
+  _playing = 1;
+  //the device stays selected for the whole playback instead of being switched for every sample
+  _device._select();
+  return 1;
+}
+
+void AD5593R_Waveform::stop() {
+  if (!_playing) return;
+  _playing = 0;
+  _device._deselect();
+}
+
+bool AD5593R_Waveform::_send_next() {
+  //only reaches the bus if another call deselected the device in between
+  _device._select();
+  AD5593R_Status status = _device._write_frames(_row(_position), _row_size);
+  if (status != AD5593R_OK) {
+    _errors++;
+    //retrying has not helped, there is no point in keeping on sending to a device that is gone
+    if (!_device.online()) stop();
+  }
+  _advance();
+  return status == AD5593R_OK;
+}
+
+void AD5593R_Waveform::_advance() {
+  if (++_position == _samples) _position = 0;
+  _next += _period;
+  _error += _remainder;
+  if (_error >= _rate) {
+    _error -= _rate;
+    _next++;
+  }
+}
+
+size_t AD5593R_Waveform::update() {
+  if (!_playing) return 0;
+  size_t sent = 0;
+  while (long(micros() - _next) >= 0) {
+    //more than a period behind, skip ahead instead of bursting out the backlog
+    if (long(micros() - _next) >= long(_period)) {
+      _late++;
+      _advance();
+      continue;
+    }
+    if (_send_next()) sent++;
+    if (!_playing) break;
+  }
+  return sent;
+}
+
+void AD5593R_Waveform::play(uint32_t sample_rate, uint32_t periods) {
+  if (!start(sample_rate)) return;
+  for (uint32_t period = 0; period < periods && _playing; period++) {
+    for (size_t i = 0; i < _samples; i++) {
+      while (long(micros() - _next) < 0) {
+      }
+      _send_next();
+    }
+  }
+  stop();
+}
@@ -0,0 +1,88 @@
+/*
+Table-driven DAC waveform playback.
+
+A waveform is computed once into a table of ready-to-send DAC frames (pointer byte, MSBs, LSBs,
+as built by AD5593R::encode_DAC_frame()). Each row of the table holds one frame per channel, so
+a sample tick is a single transaction that updates every channel, with no scaling, range checks
+or encoding at play time. The table lives in memory supplied by the caller: it needs
+3 * channels * samples bytes.
+
+Playback is paced with micros(). update() is non-blocking and meant to be called from loop(),
+play() blocks and gives the most stable rate.
+*/
+#pragma once
+#include <Arduino.h>
+#include "AD5593R.h"
+
+class AD5593R_Waveform {
+public:
+  // table is the frame storage, table_size its size in bytes
+  AD5593R_Waveform(AD5593R& device, byte* table, size_t table_size);
+
+  // Lays out the table for samples per period on the channels in the bit mask channels.
+  // Returns 0 if a channel is not a DAC or the table is too small. Every sample starts at code 0.
+  bool set_length(byte channels, size_t samples);
+
+  // Fills the samples of a channel with one period of a sine, offset and amplitude are in codes,
+  // phase in degrees. Codes outside 0-4095 are clipped.
+  void set_sine(byte channel, uint16_t offset, uint16_t amplitude, float phase = 0);
+
+  // fills the samples of a channel with a linear ramp from start to end (inclusive)
+  void set_ramp(byte channel, uint16_t start, uint16_t end);
+
+  // copies samples raw 12-bit codes into a channel
+  void set_samples(byte channel, const uint16_t* codes);
+  void set_sample(byte channel, size_t index, uint16_t code);
+
+  // Starts playback at sample_rate samples per second from the first sample. The device is selected
+  // once and stays selected until stop(), without an AD5593R_Bus other devices on the bus should not
+  // be used while it plays. Returns 0 without starting if no table is set or sample_rate is 0 or above
+  // 1 MHz, the shortest period micros() can time
+  bool start(uint32_t sample_rate);
+  void stop();
+  bool playing() const { return _playing; }
+
+  // Sends every sample that is due, returns the number the device took. If playback falls more than one
+  // period behind, the missed samples are skipped and counted in late(). Failed writes are counted in
+  // errors(), playback stops once the device has gone offline
+  size_t update();
+
+  // plays the given number of whole periods, blocking until they are done
+  void play(uint32_t sample_rate, uint32_t periods);
+
+  size_t samples() const { return _samples; }
+  unsigned long late() const { return _late; }
+  unsigned long errors() const { return _errors; }
+
+private:
+  // row of frames for one sample, one frame per channel
+  byte* _row(size_t index) { return _table + index * _row_size; }
+
+  // offset of a channel's frame within a row, -1 if the channel is not in the table
+  int _offset(byte channel);
+
+  // sends the current row and moves on, returns 0 if the write failed
+  bool _send_next();
+
+  // moves on to the next sample and its due time
+  void _advance();
+
+  AD5593R& _device;
+  byte* _table;
+  size_t _table_size;
+
+  byte _channels = 0;
+  size_t _samples = 0;
+  size_t _row_size = 0;
+  size_t _position = 0;
+
+  // sample period in whole microseconds, with the remainder spread Bresenham style
+  uint32_t _period = 0;
+  uint32_t _remainder = 0;
+  uint32_t _rate = 0;
+  uint32_t _error = 0;
+  unsigned long _next = 0;
+  bool _playing = 0;
+  unsigned long _late = 0;
+  unsigned long _errors = 0;
+};
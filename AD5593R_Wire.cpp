@@ -0,0 +1,112 @@
+#include "AD5593R_Wire.h"
+#include "AD5593R_Trace.h"
+#include <new>
+
+// handed out for a controller that did not get a transport of its own, every transaction fails
+class AD5593R_Unconnected_Transport : public AD5593R_Transport {
+public:
+  void begin() {}
+  void attach_a0(int pin) {}
+  void set_a0(int pin, bool level) {}
+  byte write(byte address, const byte* data, size_t length) { return 4; }
+  size_t read(byte address, byte* data, size_t length) { return 0; }
+};
+
+AD5593R_Transport& AD5593R_default_transport() {
+  static AD5593R_Wire_Transport transport(Wire);
+  return transport;
+}
+
+AD5593R_Transport& AD5593R_wire_transport(TwoWire& wire) {
+  if (&wire == &Wire) return AD5593R_default_transport();
+  //the transports are constructed in place on first use, nothing is allocated
+  static TwoWire* wires[AD5593R_WIRE_BUSES - 1];
+  alignas(AD5593R_Wire_Transport) static byte storage[AD5593R_WIRE_BUSES - 1][sizeof(AD5593R_Wire_Transport)];
+  static byte count = 0;
+  for (byte i = 0; i < count; i++) {
+    if (wires[i] == &wire) return *reinterpret_cast<AD5593R_Wire_Transport*>(storage[i]);
+  }
+  if (count == AD5593R_WIRE_BUSES - 1) {
+    //falling back to Wire would quietly put the devices on the wrong bus
+    static AD5593R_Unconnected_Transport unconnected;
+    AD5593R_LOG_ERROR(AD5593R_EVENT_NO_TRANSPORT, 0xff, AD5593R_WIRE_BUSES);
+    return unconnected;
+  }
+  wires[count] = &wire;
+  return *new (storage[count++]) AD5593R_Wire_Transport(wire);
+}
+
+AD5593R_Wire_Transport::AD5593R_Wire_Transport(TwoWire& wire) : _wire(wire) {
+}
+
+void AD5593R_Wire_Transport::set_pins(int sda, int scl) {
+  _sda = sda;
+  _scl = scl;
+}
+
+bool AD5593R_Wire_Transport::stuck() {
+  return _sda > -1 && digitalRead(_sda) == LOW;
+}
+
+void AD5593R_Wire_Transport::begin() {
+  if (_begun) return;
+#ifdef ARDUINO_ARCH_ESP32
+  if (_sda > -1 && _scl > -1) {
+    _wire.begin(_sda, _scl);
+    _begun = 1;
+    return;
+  }
+#endif
+  _wire.begin();
+  _begun = 1;
+}
+
+void AD5593R_Wire_Transport::attach_a0(int pin) {
+  if (pin < 0) return;
+  pinMode(pin, OUTPUT);
+  digitalWrite(pin, HIGH);
+}
+
+void AD5593R_Wire_Transport::set_a0(int pin, bool level) {
+  if (pin > -1) digitalWrite(pin, level ? HIGH : LOW);
+}
+
+byte AD5593R_Wire_Transport::write(byte address, const byte* data, size_t length) {
+  _wire.beginTransmission(address);
+  _wire.write(data, length);
+  return _wire.endTransmission();
+}
+
+size_t AD5593R_Wire_Transport::read(byte address, byte* data, size_t length) {
+  _wire.requestFrom(int(address), int(length), int(1));
+  size_t received = 0;
+  while (received < length && _wire.available()) {
+    data[received++] = _wire.read();
+  }
+  return received;
+}
+
+void AD5593R_Wire_Transport::recover() {
+  _wire.end();
+  _begun = 0;
+  if (_sda > -1 && _scl > -1) {
+    //the lines are only ever released (pulled up) or driven low, as an open drain output would
+    pinMode(_sda, INPUT_PULLUP);
+    pinMode(_scl, INPUT_PULLUP);
+    delayMicroseconds(5);
+    for (int i = 0; i < 9 && digitalRead(_sda) == LOW; i++) {
+      pinMode(_scl, OUTPUT);
+      digitalWrite(_scl, LOW);
+      delayMicroseconds(5);
+      pinMode(_scl, INPUT_PULLUP);
+      delayMicroseconds(5);
+    }
+    //STOP: SDA goes high while SCL is high
+    pinMode(_sda, OUTPUT);
+    digitalWrite(_sda, LOW);
+    delayMicroseconds(5);
+    pinMode(_sda, INPUT_PULLUP);
+    delayMicroseconds(5);
+  }
+  begin();
+}
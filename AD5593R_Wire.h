@@ -0,0 +1,39 @@
+/*
+AD5593R_Transport implementation on top of the Arduino Wire library.
+*/
+#pragma once
+#include <Arduino.h>
+#include <Wire.h>
+#include "AD5593R_Transport.h"
+
+class AD5593R_Wire_Transport : public AD5593R_Transport {
+public:
+  // wire is the I2C controller the AD5593Rs are connected to
+  AD5593R_Wire_Transport(TwoWire& wire);
+
+  // Pins of the bus, needed by recover() to free SDA. Without them recover() only restarts the controller.
+  // On ESP32 the controller is also started on these pins
+  void set_pins(int sda, int scl);
+
+  // SDA read low between transactions, only known once set_pins() has been called
+  bool stuck();
+
+  void begin();
+  void attach_a0(int pin);
+  void set_a0(int pin, bool level);
+  byte write(byte address, const byte* data, size_t length);
+  size_t read(byte address, byte* data, size_t length);
+
+  // Clocks SCL up to 9 times until the device holding SDA low lets go, sends a STOP,
+  // and starts the controller again
+  void recover();
+
+private:
+  TwoWire& _wire;
+
+  int _sda = -1;
+  int _scl = -1;
+
+  // set once begin() has been called, so several devices can share the bus
+  bool _begun = 0;
+};
@@ -0,0 +1,86 @@
+#include "AD5593R_Capture_Reader.h"
+#include "AD5593R_Capture.h"
+
+void AD5593R_Capture_Columns::clear() {
+  time.clear();
+  device.clear();
+  for (int i = 0; i < 8; i++) {
+    codes[i].clear();
+    volts[i].clear();
+  }
+}
+
+static int count_channels(uint8_t channels) {
+  int count = 0;
+  for (; channels; channels &= channels - 1) count++;
+  return count;
+}
+
+size_t AD5593R_Capture_Reader::_frame_size(const uint8_t* data) {
+  if (data[0] != AD5593R_CAPTURE_SYNC_0 || data[1] != AD5593R_CAPTURE_SYNC_1) return 0;
+  if (data[2] != AD5593R_CAPTURE_VERSION || data[4] == 0 || data[8] == 0) return 0;
+  size_t codes = size_t(data[8]) * count_channels(data[4]);
+  return AD5593R_CAPTURE_HEADER_SIZE + 2 * data[8] + (3 * codes + 1) / 2 + 2;
+}
+
+size_t AD5593R_Capture_Reader::feed(const uint8_t* data, size_t length) {
+  _pending.insert(_pending.end(), data, data + length);
+  size_t decoded = 0;
+  size_t start = 0;
+  while (_pending.size() - start >= AD5593R_CAPTURE_HEADER_SIZE) {
+    const uint8_t* frame = _pending.data() + start;
+    size_t size = _frame_size(frame);
+    if (size == 0) {
+      start++;
+      _skipped_bytes++;
+      continue;
+    }
+    if (_pending.size() - start < size) break;
+    uint16_t crc = frame[size - 2] | (frame[size - 1] << 8);
+    if (AD5593R_Capture::crc16(frame + 2, size - 4) != crc) {
+      // a false sync or a damaged frame, look for the next sync after this one
+      _crc_errors++;
+      start++;
+      _skipped_bytes++;
+      continue;
+    }
+    _decode(frame);
+    _frames++;
+    decoded++;
+    start += size;
+  }
+  _pending.erase(_pending.begin(), _pending.begin() + start);
+  return decoded;
+}
+
+void AD5593R_Capture_Reader::_decode(const uint8_t* frame) {
+  uint8_t id = frame[3];
+  uint8_t channels = frame[4];
+  double range = (frame[6] | (frame[7] << 8)) / 1000.0 * ((frame[5] & 0x01) ? 2 : 1);
+  int scans = frame[8];
+  uint32_t time = frame[9] | (frame[10] << 8) | (frame[11] << 16) | (uint32_t(frame[12]) << 24);
+  const uint8_t* deltas = frame + AD5593R_CAPTURE_HEADER_SIZE;
+  const uint8_t* packed = deltas + 2 * scans;
+
+  size_t code_index = 0;
+  for (int scan = 0; scan < scans; scan++) {
+    time += deltas[2 * scan] | (deltas[2 * scan + 1] << 8);
+    if (_seen[id] && time < _last_time[id]) _wraps[id]++;
+    _seen[id] = 1;
+    _last_time[id] = time;
+    _columns.time.push_back((_wraps[id] << 32) | time);
+    _columns.device.push_back(id);
+    for (int i = 0; i < 8; i++) {
+      if (!(channels & (1 << i))) {
+        _columns.codes[i].push_back(-1);
+        _columns.volts[i].push_back(0);
+        continue;
+      }
+      const uint8_t* p = packed + code_index / 2 * 3;
+      int code = (code_index & 1) ? ((p[1] & 0x0f) << 8) | p[2] : (p[0] << 4) | (p[1] >> 4);
+      code_index++;
+      _columns.codes[i].push_back(code);
+      _columns.volts[i].push_back(code * range / 4095);
+    }
+  }
+}
@@ -0,0 +1,48 @@
+/*
+Host side decoder of the frames written by AD5593R_Capture, see AD5593R_Capture.h for the format.
+Bytes are fed in as they arrive, e.g. from a serial port or a file; complete frames are decoded
+into columns, one row per scan. Bytes that do not start a valid frame (text printed on the same
+port, a frame cut by a reset) are skipped until the next sync bytes.
+*/
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+struct AD5593R_Capture_Columns {
+  std::vector<uint64_t> time;       // micros() of the scan, extended past the 32 bit wrap per device
+  std::vector<uint8_t> device;      // device id of the writer
+  std::vector<int> codes[8];        // code of each channel, -1 if the channel was not in the scan
+  std::vector<double> volts[8];     // the code in volts, 0 if the channel was not in the scan or Vref is unknown
+  size_t rows() const { return time.size(); }
+  void clear();
+};
+
+class AD5593R_Capture_Reader {
+public:
+  // decodes the complete frames in data and what was left from previous calls, returns the number of frames decoded
+  size_t feed(const uint8_t* data, size_t length);
+
+  const AD5593R_Capture_Columns& columns() const { return _columns; }
+  // drops the decoded rows, e.g. after they are processed
+  void clear_columns() { _columns.clear(); }
+
+  unsigned long frames() const { return _frames; }
+  unsigned long crc_errors() const { return _crc_errors; }
+  unsigned long skipped_bytes() const { return _skipped_bytes; }
+
+private:
+  // size of the frame at data, 0 if it does not hold a valid header
+  static size_t _frame_size(const uint8_t* data);
+  void _decode(const uint8_t* frame);
+
+  std::vector<uint8_t> _pending;
+  AD5593R_Capture_Columns _columns;
+  // last 32 bit time and the wraps seen for each device id
+  uint32_t _last_time[256] = {0};
+  uint64_t _wraps[256] = {0};
+  bool _seen[256] = {0};
+  unsigned long _frames = 0;
+  unsigned long _crc_errors = 0;
+  unsigned long _skipped_bytes = 0;
+};
@@ -0,0 +1,306 @@
+#include "AD5593R_Sim.h"
+#include "AD5593R_Registers.h"
+
+// Pointer byte modes as given in the AD5593R datasheet (table 11). They are
+// spelled out here rather than taken from the driver so that a wrong driver
+// constant shows up as a failing exchange instead of being mirrored.
+static const byte _SIM_DAC_WRITE = 0x10;
+static const byte _SIM_ADC_READ = 0x40;
+static const byte _SIM_DAC_READ = 0x50;
+static const byte _SIM_GPIO_READ = 0x60;
+static const byte _SIM_REG_READ = 0x70;
+
+AD5593R_Transport& AD5593R_default_transport() {
+  return AD5593R_Sim_Bus::default_bus();
+}
+
+AD5593R_Sim::AD5593R_Sim(int a0) {
+  _a0_pin = a0;
+  // like the driver, a chip with an a0 pin starts out not selected
+  _a0_level = a0 > -1;
+  _external_Vref = 2.5f;
+  _temperature = 25.0f;
+  for (int i = 0; i < 8; i++) {
+    _inputs[i] = 0;
+  }
+  reset();
+}
+
+void AD5593R_Sim::reset() {
+  for (int i = 0; i < 16; i++) {
+    _regs[i] = 0x0000;
+  }
+  // all pins have their pull-down enabled after a reset
+  _regs[_ADAC_PULL_DOWN] = 0x00ff;
+  for (int i = 0; i < 8; i++) {
+    _dac_input[i] = 0;
+    _dac_output[i] = 0;
+  }
+  _read_pointer = _SIM_ADC_READ;
+  _sequence_position = 0;
+  _sequence_done = 0;
+  _last_conversion = 0;
+}
+
+float AD5593R_Sim::Vref() const {
+  if (_regs[_ADAC_POWER_REF_CTRL] & (_ADAC_VREF_ON << 8)) return 2.5f;
+  return _external_Vref;
+}
+
+float AD5593R_Sim::pin_voltage(byte channel) const {
+  channel &= 7;
+  uint16_t channel_bit = 1 << channel;
+  if (_regs[_ADAC_DAC_CONFIG] & channel_bit) {
+    // powered down DACs pull their output to ground
+    if (_regs[_ADAC_POWER_REF_CTRL] & (channel_bit | 0x0100)) return 0;
+    float range = Vref() * ((_regs[_ADAC_GP_CONTROL] & _ADAC_DAC_RANGE_2X) ? 2 : 1);
+    return range * _dac_output[channel] / 4096;
+  }
+  if (_regs[_ADAC_GPIO_WR_CONFIG] & channel_bit) {
+    return (_regs[_ADAC_GPIO_WR_DATA] & channel_bit) ? _VDD : 0;
+  }
+  return _inputs[channel];
+}
+
+uint16_t AD5593R_Sim::_convert(float voltage) const {
+  float range = Vref() * ((_regs[_ADAC_GP_CONTROL] & _ADAC_ADC_RANGE_2X) ? 2 : 1);
+  if (range <= 0) return 0;
+  long code = long(voltage / range * 4096 + 0.5f);
+  if (code < 0) code = 0;
+  if (code > 4095) code = 4095;
+  return uint16_t(code);
+}
+
+uint16_t AD5593R_Sim::_temperature_code() const {
+  // inverse of the temperature equations in the data sheet
+  float Vref = this->Vref();
+  float code;
+  if (_regs[_ADAC_GP_CONTROL] & _ADAC_ADC_RANGE_2X) {
+    code = (0.5f / (2 * Vref)) * 4095 + (_temperature - 25) * 1.327f * (2.5f / Vref);
+  }
+  else {
+    code = (0.5f / Vref) * 4095 + (_temperature - 25) * 2.654f * (2.5f / Vref);
+  }
+  if (code < 0) code = 0;
+  if (code > 4095) code = 4095;
+  return uint16_t(code + 0.5f);
+}
+
+uint16_t AD5593R_Sim::_next_conversion() {
+  uint16_t sequence = _regs[_ADAC_ADC_SEQUENCE];
+  // bits 0-7 select the channels, bit 8 the temperature indicator
+  uint16_t enabled = sequence & 0x01ff;
+  bool repeat = sequence & (_ADAC_SEQUENCE_ON << 8);
+  if (enabled == 0 || _sequence_done) return _last_conversion;
+
+  for (int pass = 0; pass < 2; pass++) {
+    while (_sequence_position < 9) {
+      byte position = _sequence_position++;
+      if (enabled & (1 << position)) {
+        if (position == 8) {
+          _last_conversion = 0x8000 | _temperature_code();
+        }
+        else {
+          _last_conversion = (uint16_t(position) << 12) | _convert(pin_voltage(position));
+        }
+        return _last_conversion;
+      }
+    }
+    // end of the sequence, without the repeat bit the sequencer stops
+    _sequence_position = 0;
+    if (!repeat) {
+      _sequence_done = 1;
+      return _last_conversion;
+    }
+  }
+  return _last_conversion;
+}
+
+void AD5593R_Sim::_write_register(byte pointer, uint16_t value) {
+  if ((pointer & 0xf0) == _SIM_DAC_WRITE) {
+    byte channel = pointer & 0x07;
+    _dac_input[channel] = value & 0x0fff;
+    if ((_regs[_ADAC_LDAC_MODE] & 0x03) == _ADAC_LDAC_DIRECT) {
+      _dac_output[channel] = _dac_input[channel];
+    }
+    return;
+  }
+
+  byte address = pointer & 0x0f;
+  switch (address) {
+    case _ADAC_NULL:
+    case _ADAC_RESERVED:
+      break;
+    case _ADAC_SOFT_RESET:
+      if (value == ((_ADAC_RESET_MSBS << 8) | _ADAC_RESET_LSBS)) reset();
+      break;
+    case _ADAC_LDAC_MODE:
+      if ((value & 0x03) == _ADAC_LDAC_LOAD) {
+        for (int i = 0; i < 8; i++) {
+          _dac_output[i] = _dac_input[i];
+        }
+        _regs[address] = _ADAC_LDAC_DIRECT;
+      }
+      else {
+        _regs[address] = value & 0x03;
+      }
+      break;
+    case _ADAC_ADC_SEQUENCE:
+      _regs[address] = value;
+      _sequence_position = 0;
+      _sequence_done = 0;
+      break;
+    default:
+      _regs[address] = value;
+      break;
+  }
+}
+
+byte AD5593R_Sim::receive(const byte* data, size_t length) {
+  size_t i = 0;
+  while (i < length) {
+    byte pointer = data[i];
+    byte type = pointer & 0xf0;
+    if (type == 0x00 || type == _SIM_DAC_WRITE) {
+      // register and DAC writes carry two data bytes, an incomplete write is ignored
+      if (i + 2 >= length) break;
+      _write_register(pointer, (uint16_t(data[i + 1]) << 8) | data[i + 2]);
+      i += 3;
+    }
+    else {
+      // read pointers take no data and select what the next read returns
+      if (type == _SIM_ADC_READ || type == _SIM_DAC_READ || type == _SIM_REG_READ || type == _SIM_GPIO_READ) {
+        _read_pointer = pointer;
+      }
+      i += 1;
+    }
+  }
+  return 0;
+}
+
+size_t AD5593R_Sim::transmit(byte* data, size_t length) {
+  byte type = _read_pointer & 0xf0;
+  uint16_t word = 0;
+  for (size_t i = 0; i < length; i++) {
+    if ((i & 1) == 0) {
+      if (type == _SIM_ADC_READ) {
+        word = _next_conversion();
+      }
+      else if (type == _SIM_DAC_READ) {
+        byte channel = _read_pointer & 0x07;
+        word = 0x8000 | (uint16_t(channel) << 12) | _dac_input[channel];
+      }
+      else if (type == _SIM_REG_READ) {
+        word = _regs[_read_pointer & 0x0f];
+      }
+      else if (type == _SIM_GPIO_READ) {
+        // GPIO read, bits 0-7 hold the level of the general-purpose inputs
+        word = 0;
+        for (int channel = 0; channel < 8; channel++) {
+          if ((_regs[_ADAC_GPIO_RD_CONFIG] & (1 << channel)) && pin_voltage(channel) > _VDD / 2) {
+            word |= 1 << channel;
+          }
+        }
+      }
+      data[i] = word >> 8;
+    }
+    else {
+      data[i] = word & 0xff;
+    }
+  }
+  return length;
+}
+
+AD5593R_Sim_Bus::AD5593R_Sim_Bus() {
+  _num_of_chips = 0;
+  _errors_to_inject = 0;
+  _injected_status = 2;
+  _sda_held = 0;
+  _clock = 0;
+  reset_stats();
+}
+
+AD5593R_Sim_Bus& AD5593R_Sim_Bus::default_bus() {
+  static AD5593R_Sim_Bus bus;
+  return bus;
+}
+
+bool AD5593R_Sim_Bus::attach(AD5593R_Sim& chip) {
+  if (_num_of_chips >= _max_chips) return 0;
+  _chips[_num_of_chips++] = &chip;
+  return 1;
+}
+
+void AD5593R_Sim_Bus::reset_stats() {
+  _stats.transactions = 0;
+  _stats.writes = 0;
+  _stats.reads = 0;
+  _stats.bytes_written = 0;
+  _stats.bytes_read = 0;
+  _stats.nacks = 0;
+  _stats.a0_changes = 0;
+  _stats.recoveries = 0;
+}
+
+AD5593R_Sim* AD5593R_Sim_Bus::_find(byte address) {
+  for (int i = 0; i < _num_of_chips; i++) {
+    if (_chips[i]->address() == address) return _chips[i];
+  }
+  return nullptr;
+}
+
+void AD5593R_Sim_Bus::begin() {
+}
+
+void AD5593R_Sim_Bus::attach_a0(int pin) {
+  set_a0(pin, HIGH);
+}
+
+void AD5593R_Sim_Bus::set_a0(int pin, bool level) {
+  if (pin < 0) return;
+  _stats.a0_changes++;
+  for (int i = 0; i < _num_of_chips; i++) {
+    if (_chips[i]->a0_pin() == pin) _chips[i]->set_a0_level(level);
+  }
+}
+
+byte AD5593R_Sim_Bus::write(byte address, const byte* data, size_t length) {
+  _stats.transactions++;
+  _stats.writes++;
+  AD5593R_Sim* chip = _find(address);
+  if (chip == nullptr || _errors_to_inject > 0) {
+    // NACK on the address, or the injected error, same codes as Wire.endTransmission()
+    if (chip == nullptr || _injected_status == 2 || _injected_status == 3) _stats.nacks++;
+    if (chip == nullptr) return 2;
+    _errors_to_inject--;
+    return _injected_status;
+  }
+  _stats.bytes_written += length;
+  _transfer_time(length);
+  return chip->receive(data, length);
+}
+
+size_t AD5593R_Sim_Bus::read(byte address, byte* data, size_t length) {
+  _stats.transactions++;
+  _stats.reads++;
+  AD5593R_Sim* chip = _find(address);
+  if (chip == nullptr || _errors_to_inject > 0) {
+    if (chip == nullptr || _injected_status == 2 || _injected_status == 3) _stats.nacks++;
+    if (chip != nullptr) _errors_to_inject--;
+    return 0;
+  }
+  size_t received = chip->transmit(data, length);
+  _stats.bytes_read += received;
+  _transfer_time(received);
+  return received;
+}
+
+void AD5593R_Sim_Bus::_transfer_time(size_t length) {
+  //address byte, data bytes, plus about two clocks for START and STOP
+  if (_clock > 0) delayMicroseconds(((length + 1) * 9 + 2) * 1000000ULL / _clock);
+}
+
+void AD5593R_Sim_Bus::recover() {
+  _sda_held = 0;
+  _stats.recoveries++;
+}
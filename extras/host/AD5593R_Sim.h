@@ -0,0 +1,144 @@
+/*
+Register-level simulation of the AD5593R for the host build.
+
+AD5593R_Sim models one chip: the control registers, the DAC input and output registers,
+the ADC sequencer and the GPIO pins. AD5593R_Sim_Bus is an AD5593R_Transport that routes
+transactions to the simulated chips attached to it, and counts every transaction and byte
+so the cost of each driver call can be measured without hardware.
+
+As on the real board, a chip answers on 0x10 while its a0 pin is LOW and on 0x11 while it is HIGH.
+A chip created without an a0 pin has a0 tied LOW.
+*/
+#pragma once
+#include <Arduino.h>
+#include "AD5593R_Transport.h"
+
+class AD5593R_Sim {
+public:
+  // a0 is the pin number the driver uses for this chip, -1 if a0 is tied LOW
+  AD5593R_Sim(int a0 = -1);
+
+  // returns the chip to its power-on state, the same as a software reset
+  void reset();
+
+  int a0_pin() const { return _a0_pin; }
+  void set_a0_level(bool level) { _a0_level = level; }
+  byte address() const { return 0x10 | (_a0_level ? 1 : 0); }
+
+  // voltage of the external reference, used while the internal reference is disabled
+  void set_external_Vref(float Vref) { _external_Vref = Vref; }
+  float Vref() const;
+
+  // voltage applied to a pin that is not driven by the chip
+  void set_input_voltage(byte channel, float voltage) { _inputs[channel & 7] = voltage; }
+
+  // drives a pin that is not driven by the chip to 0 V or VDD
+  void set_input_level(byte channel, bool level) { set_input_voltage(channel, level ? _VDD : 0); }
+
+  // die temperature reported through the temperature indicator
+  void set_temperature(float celsius) { _temperature = celsius; }
+
+  // voltage present on a pin, either driven by the chip (DAC, GPO) or applied with set_input_voltage()
+  float pin_voltage(byte channel) const;
+
+  uint16_t reg(byte address) const { return _regs[address & 0x0f]; }
+  uint16_t dac_input(byte channel) const { return _dac_input[channel & 7]; }
+  uint16_t dac_output(byte channel) const { return _dac_output[channel & 7]; }
+
+  // handles a write transaction addressed to this chip, returns a Wire.endTransmission() status
+  byte receive(const byte* data, size_t length);
+
+  // handles a read transaction addressed to this chip, returns the number of bytes sent
+  size_t transmit(byte* data, size_t length);
+
+private:
+  void _write_register(byte pointer, uint16_t value);
+  uint16_t _next_conversion();
+  uint16_t _convert(float voltage) const;
+  uint16_t _temperature_code() const;
+
+  // supply voltage, the level of a GPO driven HIGH
+  static constexpr float _VDD = 3.3f;
+
+  int _a0_pin;
+  bool _a0_level;
+
+  uint16_t _regs[16];
+  uint16_t _dac_input[8];
+  uint16_t _dac_output[8];
+
+  // pointer byte selecting what the next read returns
+  byte _read_pointer;
+
+  // position in the ADC sequence, 0-7 are the channels and 8 the temperature indicator
+  byte _sequence_position;
+  bool _sequence_done;
+  uint16_t _last_conversion;
+
+  float _external_Vref;
+  float _inputs[8];
+  float _temperature;
+};
+
+class AD5593R_Sim_Bus : public AD5593R_Transport {
+public:
+  // counts of everything that went over the bus since the last reset_stats()
+  struct stats {
+    unsigned long transactions;
+    unsigned long writes;
+    unsigned long reads;
+    unsigned long bytes_written;
+    unsigned long bytes_read;
+    unsigned long nacks;
+    unsigned long a0_changes;
+    unsigned long recoveries;
+  };
+
+  AD5593R_Sim_Bus();
+
+  // attaches a chip to the bus, returns 0 if the bus is full
+  bool attach(AD5593R_Sim& chip);
+
+  const stats& get_stats() const { return _stats; }
+  void reset_stats();
+
+  // Makes the next count transactions fail with status, by default as if the device did not answer
+  // (2, see Wire.endTransmission()), to exercise the retries and the health tracking of the driver.
+  // A failed read returns no bytes whatever the status
+  void inject_errors(unsigned long count, byte status = 2) {
+    _errors_to_inject = count;
+    _injected_status = status;
+  }
+
+  // holds SDA low, as a device that lost track of a transaction would, until recover() is called
+  void hold_sda() { _sda_held = 1; }
+
+  // Makes every transaction take as long as it would at an SCL frequency of hz (9 clocks per byte,
+  // address included), so timing and the overlap of several buses can be measured. 0, the default, takes no time
+  void set_clock(unsigned long hz) { _clock = hz; }
+
+  void begin();
+  void attach_a0(int pin);
+  void set_a0(int pin, bool level);
+  byte write(byte address, const byte* data, size_t length);
+  size_t read(byte address, byte* data, size_t length);
+  void recover();
+  bool stuck() { return _sda_held; }
+
+  // the bus the default transport routes to in the host build
+  static AD5593R_Sim_Bus& default_bus();
+
+private:
+  AD5593R_Sim* _find(byte address);
+
+  static const int _max_chips = 8;
+  AD5593R_Sim* _chips[_max_chips];
+  int _num_of_chips;
+  stats _stats;
+  unsigned long _errors_to_inject;
+  byte _injected_status;
+  bool _sda_held;
+  unsigned long _clock;
+
+  void _transfer_time(size_t length);
+};
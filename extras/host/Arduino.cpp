@@ -0,0 +1,92 @@
+#include "Arduino.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <thread>
+
+HardwareSerial Serial;
+
+// a0 pins and other GPIOs only exist on the simulated bus, see AD5593R_Sim.h
+void pinMode(int pin, int mode) {
+  (void)pin;
+  (void)mode;
+}
+
+void digitalWrite(int pin, int level) {
+  (void)pin;
+  (void)level;
+}
+
+static std::chrono::steady_clock::time_point start_time() {
+  static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  return start;
+}
+
+unsigned long micros() {
+  return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(
+           std::chrono::steady_clock::now() - start_time()).count();
+}
+
+unsigned long millis() {
+  return micros() / 1000;
+}
+
+void delay(unsigned long ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(unsigned int us) {
+  std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+size_t Print::write(uint8_t value) {
+  return write(&value, 1);
+}
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+  return fwrite(buffer, 1, size, stdout);
+}
+
+size_t Print::_print_formatted(const char* format, ...) {
+  char text[64];
+  va_list arguments;
+  va_start(arguments, format);
+  int length = vsnprintf(text, sizeof(text), format, arguments);
+  va_end(arguments);
+  if (length < 0) return 0;
+  if (length >= int(sizeof(text))) length = sizeof(text) - 1;
+  return write((const uint8_t*)text, length);
+}
+
+size_t Print::print(const char* text) {
+  return write((const uint8_t*)text, strlen(text));
+}
+
+size_t Print::print(char c) {
+  return write(uint8_t(c));
+}
+
+size_t Print::print(int value) {
+  return _print_formatted("%d", value);
+}
+
+size_t Print::print(unsigned int value) {
+  return _print_formatted("%u", value);
+}
+
+size_t Print::print(long value) {
+  return _print_formatted("%ld", value);
+}
+
+size_t Print::print(unsigned long value) {
+  return _print_formatted("%lu", value);
+}
+
+size_t Print::print(double value, int digits) {
+  return _print_formatted("%.*f", digits, value);
+}
+
+size_t Print::println() {
+  return write(uint8_t('\n'));
+}
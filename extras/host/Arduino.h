@@ -0,0 +1,52 @@
+/*
+Minimal stand-in for the Arduino core, used to build the AD5593R library on a Linux host.
+Only the parts of the Arduino API used by the library are provided.
+*/
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint8_t byte;
+
+#define LOW    0
+#define HIGH   1
+#define INPUT  0
+#define OUTPUT 1
+
+void pinMode(int pin, int mode);
+void digitalWrite(int pin, int level);
+
+unsigned long micros();
+unsigned long millis();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+// mirrors the Arduino Print class, everything goes through write(), which writes to stdout unless overridden
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t value);
+  virtual size_t write(const uint8_t* buffer, size_t size);
+  size_t print(const char* text);
+  size_t print(char c);
+  size_t print(int value);
+  size_t print(unsigned int value);
+  size_t print(long value);
+  size_t print(unsigned long value);
+  size_t print(double value, int digits = 2);
+  size_t println();
+  template <typename T> size_t println(T value) {
+    size_t n = print(value);
+    return n + println();
+  }
+
+private:
+  size_t _print_formatted(const char* format, ...);
+};
+
+class HardwareSerial : public Print {
+public:
+  void begin(unsigned long baud) { (void)baud; }
+};
+
+extern HardwareSerial Serial;
@@ -0,0 +1,126 @@
+/*
+Runs each AD5593R call against the simulated chip and prints the bus traffic it caused.
+Build with CMake from this directory, see README.md.
+*/
+#include <stdio.h>
+#include "AD5593R.h"
+#include "AD5593R_Async.h"
+#include "AD5593R_Bus.h"
+#include "AD5593R_Waveform.h"
+#include "AD5593R_Sim.h"
+
+static AD5593R_Sim_Bus bus;
+
+static void report(const char* call) {
+  const AD5593R_Sim_Bus::stats& stats = bus.get_stats();
+  printf("%-28s %4lu transactions %5lu bytes written %5lu bytes read %4lu a0 changes\n",
+         call, stats.transactions, stats.bytes_written, stats.bytes_read, stats.a0_changes);
+  bus.reset_stats();
+}
+
+// four devices behind a bus manager
+static void report_bus() {
+  static AD5593R_Sim chips[4] = {AD5593R_Sim(30), AD5593R_Sim(31), AD5593R_Sim(32), AD5593R_Sim(33)};
+  AD5593R devices[4] = {AD5593R(bus, 30), AD5593R(bus, 31), AD5593R(bus, 32), AD5593R(bus, 33)};
+  AD5593R_Bus manager(bus);
+  AD5593R::configuration pins = {{0, 0, 0, 0, 1, 1, 1, 1}, {1, 1, 1, 1, 0, 0, 0, 0}, {0}, {0}};
+  for (int i = 0; i < 4; i++) {
+    bus.attach(chips[i]);
+    manager.add(devices[i]);
+    devices[i].configure_pins(&pins);
+  }
+  bus.reset_stats();
+
+  AD5593R_Frame frames[4];
+  manager.scan_all(frames);
+  report("AD5593R_Bus::scan_all() x4");
+  for (int i = 0; i < 16; i++) {
+    manager.queue_DAC_code(i % 4, i / 4, 1000);
+  }
+  manager.execute();
+  report("AD5593R_Bus::execute() 16");
+}
+
+int main() {
+  AD5593R_Sim chip(23);
+  bus.attach(chip);
+  for (int i = 0; i < 8; i++) {
+    chip.set_input_voltage(i, 0.3f * i);
+  }
+
+  AD5593R device(bus, 23);
+  bool DACs[8] = {1, 1, 1, 1, 0, 0, 0, 0};
+  bool ADCs[8] = {0, 0, 0, 0, 1, 1, 1, 1};
+  bus.reset_stats();
+
+  device.enable_internal_Vref();
+  report("enable_internal_Vref()");
+  device.set_ADC_max_2x_Vref();
+  report("set_ADC_max_2x_Vref()");
+  device.set_DAC_max_2x_Vref();
+  report("set_DAC_max_2x_Vref()");
+  device.set_ADC_max_2x_Vref();
+  report("set_ADC_max_2x_Vref() again");
+  device.configure_DACs(DACs);
+  report("configure_DACs()");
+  device.configure_ADCs(ADCs);
+  report("configure_ADCs()");
+
+  AD5593R::configuration pins = {{0, 0, 0, 0, 1, 1, 1, 1}, {1, 1, 1, 1, 0, 0, 0, 0}, {0}, {0}};
+  device.configure_pins(&pins);
+  report("configure_pins()");
+  device.configure_pins(&pins);
+  report("configure_pins() unchanged");
+
+  device.write_DAC(0, 1.25f);
+  report("write_DAC()");
+  float voltages[8] = {0.5f, 1.0f, 1.5f, 2.0f, 0, 0, 0, 0};
+  device.write_DACs(voltages);
+  report("write_DACs()");
+  device.read_ADC(4);
+  report("read_ADC()");
+  device.read_ADCs();
+  report("read_ADCs()");
+
+  static AD5593R_Sample_Buffer samples;
+  device.start_ADC_stream(samples);
+  report("start_ADC_stream()");
+  device.poll_ADC_stream(64);
+  report("poll_ADC_stream(64)");
+  device.stop_ADC_stream();
+
+#ifdef AD5593R_STATS
+  //the same calls as counted by the driver itself
+  AD5593R_Stats stats;
+  device.get_stats(&stats);
+  printf("\nper-operation counters\n");
+  stats.print(Serial);
+  printf("\n");
+#endif
+
+  report_bus();
+
+  //one period of a 64 sample sine on two channels
+  static byte table[3 * 2 * 64];
+  AD5593R_Waveform waveform(device, table, sizeof(table));
+  waveform.set_length(0x03, 64);
+  waveform.set_sine(0, 2048, 2000);
+  waveform.set_sine(1, 2048, 2000, 90);
+  bus.reset_stats();
+  waveform.play(10000, 1);
+  report("AD5593R_Waveform 64 samples");
+
+  //the same DAC write through the worker task, the caller only pays for the enqueue
+  AD5593R_Async async(device);
+  async.begin();
+  unsigned long start = micros();
+  for (int i = 0; i < 16; i++) {
+    async.write_DAC_code(0, i * 256);
+  }
+  unsigned long queued = micros() - start;
+  async.wait_idle();
+  async.end();
+  report("AD5593R_Async 16 writes");
+  printf("%-28s %4lu us to queue\n", "", queued);
+  return 0;
+}
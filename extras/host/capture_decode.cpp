@@ -0,0 +1,44 @@
+/*
+Decodes a capture written by AD5593R_Capture into CSV, one row per scan:
+  ad5593r_capture_decode [file]
+reads the file, or stdin if none is given (e.g. a serial port: ad5593r_capture_decode < /dev/ttyUSB0).
+Channels that are not in a scan are left empty.
+*/
+#include <stdio.h>
+#include "AD5593R_Capture_Reader.h"
+
+static void print_rows(AD5593R_Capture_Reader& reader) {
+  const AD5593R_Capture_Columns& columns = reader.columns();
+  for (size_t row = 0; row < columns.rows(); row++) {
+    printf("%llu,%u", (unsigned long long)columns.time[row], columns.device[row]);
+    for (int i = 0; i < 8; i++) {
+      if (columns.codes[i][row] < 0) printf(",");
+      else printf(",%.4f", columns.volts[i][row]);
+    }
+    printf("\n");
+  }
+  reader.clear_columns();
+}
+
+int main(int argc, char** argv) {
+  FILE* in = stdin;
+  if (argc > 1) {
+    in = fopen(argv[1], "rb");
+    if (!in) {
+      perror(argv[1]);
+      return 1;
+    }
+  }
+  AD5593R_Capture_Reader reader;
+  printf("time_us,device,ch0,ch1,ch2,ch3,ch4,ch5,ch6,ch7\n");
+  uint8_t buffer[4096];
+  size_t length;
+  while ((length = fread(buffer, 1, sizeof(buffer), in)) > 0) {
+    reader.feed(buffer, length);
+    print_rows(reader);
+  }
+  if (in != stdin) fclose(in);
+  fprintf(stderr, "%lu frames, %lu CRC errors, %lu bytes skipped\n",
+          reader.frames(), reader.crc_errors(), reader.skipped_bytes());
+  return 0;
+}
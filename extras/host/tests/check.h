@@ -0,0 +1,43 @@
+/*
+Assertions for the host tests. A failed check prints where it is and what it compared and the test
+goes on, main() returns check_result() so ctest reports the test as failed.
+*/
+#pragma once
+#include <stdio.h>
+
+static int check_failures = 0;
+
+#define CHECK(condition)                                                              \
+  do {                                                                                \
+    if (!(condition)) {                                                               \
+      printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition);            \
+      check_failures++;                                                               \
+    }                                                                                 \
+  } while (0)
+
+#define CHECK_EQUAL(actual, expected)                                                 \
+  do {                                                                                \
+    long check_actual = long(actual);                                                 \
+    long check_expected = long(expected);                                             \
+    if (check_actual != check_expected) {                                             \
+      printf("%s:%d: CHECK_EQUAL(%s, %s) failed, %ld != %ld\n", __FILE__, __LINE__,   \
+             #actual, #expected, check_actual, check_expected);                       \
+      check_failures++;                                                               \
+    }                                                                                 \
+  } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance)                                       \
+  do {                                                                                \
+    double check_actual = double(actual);                                             \
+    double check_expected = double(expected);                                         \
+    if (check_actual < check_expected - (tolerance) || check_actual > check_expected + (tolerance)) { \
+      printf("%s:%d: CHECK_NEAR(%s, %s) failed, %g is not within %g of %g\n", __FILE__, __LINE__, \
+             #actual, #expected, check_actual, double(tolerance), check_expected);    \
+      check_failures++;                                                               \
+    }                                                                                 \
+  } while (0)
+
+static int check_result() {
+  if (check_failures) printf("%d checks failed\n", check_failures);
+  return check_failures ? 1 : 0;
+}
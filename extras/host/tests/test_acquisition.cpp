@@ -0,0 +1,82 @@
+/*
+Checks that AD5593R_Acquisition merges the scans of two buses into time-ordered records, with
+every frame carrying the codes of the device it names.
+*/
+#include "check.h"
+#include "AD5593R.h"
+#include "AD5593R_Acquisition.h"
+#include "AD5593R_Sim.h"
+
+static AD5593R_Sim_Bus buses[2];
+static AD5593R_Sim chips[2][2] = {{AD5593R_Sim(20), AD5593R_Sim(21)}, {AD5593R_Sim(20), AD5593R_Sim(21)}};
+
+// code of channel 0 of a device, different on every device
+static uint16_t expected_code(byte bus, byte device) {
+  return uint16_t((bus * 2 + device + 1) * 0.25f / 2.5f * 4095 + 0.5f);
+}
+
+int main() {
+  AD5593R* devices[2][2];
+  AD5593R_Bus* managers[2];
+  AD5593R::configuration pins = {{1, 0, 0, 0, 0, 0, 0, 0}, {0}, {0}, {0}};
+  for (byte bus = 0; bus < 2; bus++) {
+    managers[bus] = new AD5593R_Bus(buses[bus]);
+    for (byte device = 0; device < 2; device++) {
+      buses[bus].attach(chips[bus][device]);
+      chips[bus][device].set_input_voltage(0, (bus * 2 + device + 1) * 0.25f);
+      devices[bus][device] = new AD5593R(buses[bus], 20 + device);
+      managers[bus]->add(*devices[bus][device]);
+      devices[bus][device]->enable_internal_Vref();
+      devices[bus][device]->configure_pins(&pins);
+    }
+  }
+
+  AD5593R_Acquisition acquisition;
+  CHECK_EQUAL(acquisition.add_bus(*managers[0]), 0);
+  CHECK_EQUAL(acquisition.add_bus(*managers[1]), 1);
+  CHECK(acquisition.begin(2000));
+  // the workers own the buses until end()
+  CHECK_EQUAL(acquisition.add_bus(*managers[0]), -1);
+
+  unsigned long records = 0;
+  unsigned long complete = 0;
+  bool ordered = true;
+  bool codes_ok = true;
+  uint32_t last_tick = 0;
+  AD5593R_Acquisition_Record record;
+  unsigned long start = millis();
+  while (millis() - start < 200) {
+    if (!acquisition.read(record)) {
+      delayMicroseconds(100);
+      continue;
+    }
+    if (records && record.tick <= last_tick) ordered = false;
+    last_tick = record.tick;
+    records++;
+    if (record.buses == 0x03) complete++;
+    byte frames_expected = 0;
+    for (byte bus = 0; bus < 2; bus++) {
+      if (record.buses & (1 << bus)) frames_expected += 2;
+    }
+    if (record.num_of_frames != frames_expected) codes_ok = false;
+    for (byte i = 0; i < record.num_of_frames; i++) {
+      const AD5593R_Acquisition_Frame& frame = record.frames[i];
+      if (!(record.buses & (1 << frame.bus)) || frame.frame.channels != 0x01) codes_ok = false;
+      uint16_t code = frame.frame.codes[0];
+      uint16_t expected = expected_code(frame.bus, frame.frame.device);
+      if (code + 2 < expected || code > expected + 2) codes_ok = false;
+    }
+  }
+  acquisition.end();
+
+  AD5593R_Acquisition_Stats stats;
+  acquisition.get_stats(&stats);
+  // 100 ticks in 200 ms
+  CHECK(records >= 50);
+  CHECK(complete >= records / 2);
+  CHECK(ordered);
+  CHECK(codes_ok);
+  CHECK(stats.scans[0] > 0 && stats.scans[1] > 0);
+  CHECK_EQUAL(stats.dropped[0] + stats.dropped[1], 0);
+  return check_result();
+}
@@ -0,0 +1,67 @@
+/*
+Measures the frames per second AD5593R_Acquisition gets from one and from two buses, with the
+simulated transactions taking as long as at 400 kHz, and checks that the second bus nearly doubles
+them. The period is shorter than a scan, so every bus runs flat out.
+*/
+#include "check.h"
+#include "AD5593R.h"
+#include "AD5593R_Acquisition.h"
+#include "AD5593R_Sim.h"
+
+static const int devices_per_bus = 4;
+
+static AD5593R_Sim_Bus buses[2];
+static AD5593R_Sim chips[2][devices_per_bus] = {
+  {AD5593R_Sim(20), AD5593R_Sim(21), AD5593R_Sim(22), AD5593R_Sim(23)},
+  {AD5593R_Sim(20), AD5593R_Sim(21), AD5593R_Sim(22), AD5593R_Sim(23)}};
+
+// frames per second scanned by num_of_buses buses in duration_ms
+static unsigned long frames_per_second(int num_of_buses, unsigned long duration_ms) {
+  AD5593R* devices[2][devices_per_bus];
+  AD5593R_Bus* managers[2];
+  AD5593R::configuration pins = {{1, 1, 1, 1, 1, 1, 1, 1}, {0}, {0}, {0}};
+  AD5593R_Acquisition acquisition;
+  for (int bus = 0; bus < num_of_buses; bus++) {
+    managers[bus] = new AD5593R_Bus(buses[bus]);
+    for (int device = 0; device < devices_per_bus; device++) {
+      devices[bus][device] = new AD5593R(buses[bus], 20 + device);
+      managers[bus]->add(*devices[bus][device]);
+      devices[bus][device]->configure_pins(&pins);
+    }
+    acquisition.add_bus(*managers[bus]);
+  }
+
+  unsigned long frames = 0;
+  AD5593R_Acquisition_Record record;
+  acquisition.begin(500);
+  unsigned long start = millis();
+  while (millis() - start < duration_ms) {
+    if (acquisition.read(record)) frames += record.num_of_frames;
+    else delayMicroseconds(100);
+  }
+  acquisition.end();
+
+  for (int bus = 0; bus < num_of_buses; bus++) {
+    for (int device = 0; device < devices_per_bus; device++) {
+      delete devices[bus][device];
+    }
+    delete managers[bus];
+  }
+  return frames * 1000 / duration_ms;
+}
+
+int main() {
+  for (int bus = 0; bus < 2; bus++) {
+    buses[bus].set_clock(400000);
+    for (int device = 0; device < devices_per_bus; device++) {
+      buses[bus].attach(chips[bus][device]);
+    }
+  }
+  unsigned long one_bus = frames_per_second(1, 300);
+  unsigned long two_buses = frames_per_second(2, 300);
+  printf("%d devices per bus at 400 kHz: 1 bus %lu frames/s, 2 buses %lu frames/s, x%.2f\n",
+         devices_per_bus, one_bus, two_buses, one_bus ? double(two_buses) / one_bus : 0.0);
+  CHECK(one_bus > 0);
+  CHECK(two_buses * 10 >= one_bus * 17);
+  return check_result();
+}
@@ -0,0 +1,58 @@
+/*
+Checks that AD5593R_Async passes the status of each driver call to its callback, failures included.
+*/
+#include "check.h"
+#include "AD5593R.h"
+#include "AD5593R_Async.h"
+#include "AD5593R_Sim.h"
+
+static AD5593R_Async_Result last;
+
+static void done(const AD5593R_Async_Result& result, void* context) {
+  (void)context;
+  last = result;
+}
+
+int main() {
+  AD5593R_Sim_Bus bus;
+  AD5593R_Sim chip;
+  bus.attach(chip);
+  AD5593R device(bus);
+  device.enable_internal_Vref();
+  AD5593R::configuration pins = {{1, 1, 0, 0, 0, 0, 0, 0}, {0}, {0, 0, 0, 0, 1, 0, 0, 0}, {0}};
+  device.configure_pins(&pins);
+  chip.set_input_voltage(1, 1.0);
+  chip.set_input_level(4, HIGH);
+
+  AD5593R_Async async(device);
+  CHECK(async.begin());
+
+  async.read_ADC_codes(done);
+  async.wait_idle();
+  CHECK_EQUAL(last.status, AD5593R_OK);
+  CHECK_EQUAL(last.channels, 0x03);
+  CHECK_NEAR(last.codes[1], 1638, 2);
+
+  async.read_GPIs(done);
+  async.wait_idle();
+  CHECK_EQUAL(last.status, AD5593R_OK);
+  CHECK_EQUAL(last.channels, 0x10);
+
+  // failed calls report their error instead of success
+  bus.inject_errors(AD5593R_RETRIES + 1);
+  async.read_ADC_codes(done);
+  async.wait_idle();
+  CHECK_EQUAL(last.status, AD5593R_ERROR_NACK);
+  CHECK_EQUAL(last.channels, 0);
+
+  bus.inject_errors(AD5593R_RETRIES + 1);
+  async.read_GPIs(done);
+  async.wait_idle();
+  CHECK(last.status < 0);
+
+  async.write_DAC_code(0, 100, done);
+  async.wait_idle();
+  CHECK_EQUAL(last.status, AD5593R_ERROR_ROLE);
+  async.end();
+  return check_result();
+}
@@ -0,0 +1,65 @@
+/*
+Checks AD5593R_Bus::execute(): the writes are grouped per device, and a device whose write fails
+keeps its values.DAC_codes and is left out of the count. Each device counts the write in its stats
+and publishes its values only when it took the write.
+*/
+#include "check.h"
+#include "AD5593R.h"
+#include "AD5593R_Bus.h"
+#include "AD5593R_Sim.h"
+
+int main() {
+  AD5593R_Sim_Bus bus;
+  AD5593R_Sim chips[2] = {AD5593R_Sim(30), AD5593R_Sim(31)};
+  AD5593R devices[2] = {AD5593R(bus, 30), AD5593R(bus, 31)};
+  AD5593R_Bus manager(bus);
+  AD5593R::configuration pins = {{0}, {1, 1, 1, 1, 0, 0, 0, 0}, {0}, {0}};
+  for (int i = 0; i < 2; i++) {
+    bus.attach(chips[i]);
+    CHECK_EQUAL(manager.add(devices[i]), i);
+    devices[i].configure_pins(&pins);
+  }
+
+  for (byte channel = 0; channel < 4; channel++) {
+    CHECK(manager.queue_DAC_code(0, channel, 100 + channel));
+    CHECK(manager.queue_DAC_code(1, channel, 200 + channel));
+  }
+  // not a DAC, dropped
+  CHECK(manager.queue_DAC_code(1, 6, 300));
+  bus.reset_stats();
+  CHECK_EQUAL(manager.execute(), 8);
+  CHECK_EQUAL(bus.get_stats().writes, 2);
+  CHECK_EQUAL(chips[0].dac_output(3), 103);
+  CHECK_EQUAL(chips[1].dac_output(3), 203);
+  CHECK_EQUAL(devices[1].values.DAC_codes[3], 203);
+
+  // the device selected last (0, the first execute() started with 1) goes first and gets the errors
+  for (byte channel = 0; channel < 4; channel++) {
+    manager.queue_DAC_code(0, channel, 1000 + channel);
+    manager.queue_DAC_code(1, channel, 2000 + channel);
+  }
+  bus.inject_errors(AD5593R_RETRIES + 1);
+#ifdef AD5593R_STATS
+  devices[0].reset_stats();
+  devices[1].reset_stats();
+#endif
+  uint32_t versions[2] = {devices[0].values_version(), devices[1].values_version()};
+  CHECK_EQUAL(manager.execute(), 4);
+  // each device counts the call as a write_DAC_codes(), only the one that took it publishes
+#ifdef AD5593R_STATS
+  AD5593R_Stats stats;
+  for (int i = 0; i < 2; i++) {
+    devices[i].get_stats(&stats);
+    CHECK_EQUAL(stats.operations[AD5593R_OP_WRITE_DACS].calls, 1);
+    CHECK_EQUAL(stats.operations[AD5593R_OP_OTHER].transactions, 0);
+  }
+#endif
+  CHECK_EQUAL(devices[0].values_version(), versions[0]);
+  CHECK(devices[1].values_version() > versions[1]);
+  CHECK_EQUAL(chips[0].dac_output(2), 102);
+  CHECK_EQUAL(devices[0].values.DAC_codes[2], 102);
+  CHECK_EQUAL(devices[0].health().last_error, AD5593R_ERROR_NACK);
+  CHECK_EQUAL(chips[1].dac_output(2), 2002);
+  CHECK_EQUAL(devices[1].values.DAC_codes[2], 2002);
+  return check_result();
+}
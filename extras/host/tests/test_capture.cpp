@@ -0,0 +1,118 @@
+/*
+Round trip of AD5593R_Capture through AD5593R_Capture_Reader: the 13-byte header, the time deltas,
+the codes packed two in three bytes (with an odd last code), the CRC-16/CCITT-FALSE, a new frame when
+the channels change, text and a damaged frame in the stream, and bytes fed one at a time.
+*/
+#include <vector>
+#include "check.h"
+#include "AD5593R.h"
+#include "AD5593R_Capture.h"
+#include "AD5593R_Capture_Reader.h"
+#include "AD5593R_Sim.h"
+
+// keeps everything written to it
+class Bytes : public Print {
+public:
+  size_t write(uint8_t value) {
+    data.push_back(value);
+    return 1;
+  }
+  size_t write(const uint8_t* buffer, size_t size) {
+    data.insert(data.end(), buffer, buffer + size);
+    return size;
+  }
+  std::vector<uint8_t> data;
+};
+
+int main() {
+  // the check value of CRC-16/CCITT-FALSE
+  const byte check_string[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+  CHECK_EQUAL(AD5593R_Capture::crc16(check_string, sizeof(check_string)), 0x29B1);
+
+  AD5593R_Sim_Bus bus;
+  AD5593R_Sim chip;
+  bus.attach(chip);
+  AD5593R device(bus);
+  device.enable_internal_Vref();
+  device.set_ADC_max_2x_Vref();
+  Bytes out;
+  AD5593R_Capture capture(device, out, 7);
+
+  // three scans of three channels, 9 codes, then one scan of a single channel in a frame of its own
+  const uint16_t scans[3][8] = {{0xabc, 0x123, 0, 0xfff}, {0x000, 0x800, 0, 0x7ff}, {0x001, 0xffe, 0, 0x456}};
+  const uint32_t times[3] = {0xfffffe00UL, 0xffffff00UL, 0x00000100UL};
+  for (int i = 0; i < 3; i++) {
+    capture.add(0x0b, scans[i], times[i]);
+  }
+  const uint16_t single[8] = {0x321};
+  capture.add(0x01, single, 0x00000200UL);
+  CHECK_EQUAL(capture.frames(), 1);
+  capture.flush();
+  CHECK_EQUAL(capture.frames(), 2);
+
+  // header, deltas, 14 bytes of codes and the CRC, then 13 + 2 + 2 + 2
+  const size_t first_size = 13 + 2 * 3 + 14 + 2;
+  CHECK_EQUAL(out.data.size(), first_size + 19);
+  const uint8_t header[13] = {0xA5, 0x5A, 1, 7, 0x0b, 0x01, 0xC4, 0x09, 3, 0x00, 0xfe, 0xff, 0xff};
+  for (int i = 0; i < 13; i++) {
+    CHECK_EQUAL(out.data[i], header[i]);
+  }
+  const uint8_t deltas[6] = {0, 0, 0x00, 0x01, 0x00, 0x02};
+  for (int i = 0; i < 6; i++) {
+    CHECK_EQUAL(out.data[13 + i], deltas[i]);
+  }
+  // 0xabc and 0x123 in three bytes, the odd last code 0x456 in two
+  CHECK_EQUAL(out.data[19], 0xab);
+  CHECK_EQUAL(out.data[20], 0xc1);
+  CHECK_EQUAL(out.data[21], 0x23);
+  CHECK_EQUAL(out.data[31], 0x45);
+  CHECK_EQUAL(out.data[32], 0x60);
+  uint16_t crc = AD5593R_Capture::crc16(out.data.data() + 2, first_size - 4);
+  CHECK_EQUAL(out.data[first_size - 2], crc & 0xff);
+  CHECK_EQUAL(out.data[first_size - 1], crc >> 8);
+
+  // text before the frames is skipped
+  AD5593R_Capture_Reader reader;
+  const uint8_t text[] = "boot\r\n";
+  CHECK_EQUAL(reader.feed(text, sizeof(text) - 1), 0);
+  CHECK_EQUAL(reader.feed(out.data.data(), out.data.size()), 2);
+  CHECK_EQUAL(reader.crc_errors(), 0);
+  CHECK_EQUAL(reader.skipped_bytes(), sizeof(text) - 1);
+  const AD5593R_Capture_Columns& columns = reader.columns();
+  CHECK_EQUAL(columns.rows(), 4);
+  for (int row = 0; row < 3; row++) {
+    CHECK_EQUAL(columns.device[row], 7);
+    CHECK_EQUAL(columns.codes[0][row], scans[row][0]);
+    CHECK_EQUAL(columns.codes[1][row], scans[row][1]);
+    CHECK_EQUAL(columns.codes[2][row], -1);
+    CHECK_EQUAL(columns.codes[3][row], scans[row][3]);
+    CHECK_NEAR(columns.volts[3][row], scans[row][3] * 5.0 / 4095, 1e-9);
+  }
+  CHECK_EQUAL(columns.codes[0][3], 0x321);
+  CHECK_EQUAL(columns.codes[1][3], -1);
+  // the time goes on past the 32 bit wrap
+  CHECK_EQUAL(columns.time[0], 0xfffffe00ULL);
+  CHECK_EQUAL(columns.time[1], 0xffffff00ULL);
+  CHECK_EQUAL(columns.time[2], 0x100000100ULL);
+  CHECK_EQUAL(columns.time[3], 0x100000200ULL);
+
+  // a damaged frame is dropped, the frame after it is still decoded
+  std::vector<uint8_t> damaged(out.data.begin(), out.data.end());
+  damaged[20] ^= 0x10;
+  AD5593R_Capture_Reader damaged_reader;
+  CHECK_EQUAL(damaged_reader.feed(damaged.data(), damaged.size()), 1);
+  CHECK_EQUAL(damaged_reader.crc_errors(), 1);
+  CHECK_EQUAL(damaged_reader.columns().rows(), 1);
+  CHECK_EQUAL(damaged_reader.columns().codes[0][0], 0x321);
+
+  // bytes fed one at a time give the same frames
+  AD5593R_Capture_Reader slow_reader;
+  size_t frames = 0;
+  for (uint8_t value : out.data) {
+    frames += slow_reader.feed(&value, 1);
+  }
+  CHECK_EQUAL(frames, 2);
+  CHECK_EQUAL(slow_reader.columns().rows(), 4);
+  CHECK_EQUAL(slow_reader.columns().codes[3][2], 0x456);
+  return check_result();
+}
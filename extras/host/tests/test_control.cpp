@@ -0,0 +1,69 @@
+/*
+Checks the integer PID of AD5593R_Control in a closed loop on the simulated chip: the DAC output is
+wired to the ADC input through a divider by 2. The loop must settle on its setpoint, and while the
+output is held at a limit the integral must stay inside the output limits, so the loop comes back
+as soon as the setpoint can be reached again.
+*/
+#include <stdlib.h>
+#include "check.h"
+#include "AD5593R.h"
+#include "AD5593R_Control.h"
+#include "AD5593R_Sim.h"
+
+// a control step followed by the plant: the ADC input sees half the DAC output
+static AD5593R_Status step(AD5593R_Control& control, AD5593R_Sim& chip) {
+  AD5593R_Status status = control.tick();
+  chip.set_input_voltage(0, chip.pin_voltage(2) / 2);
+  return status;
+}
+
+int main() {
+  AD5593R_Sim_Bus bus;
+  AD5593R_Sim chip;
+  bus.attach(chip);
+  AD5593R device(bus);
+  device.enable_internal_Vref();
+  AD5593R::configuration pins = {{1, 0, 0, 0, 0, 0, 0, 0}, {0, 0, 1, 0, 0, 0, 0, 0}, {0}, {0}};
+  CHECK_EQUAL(device.configure_pins(&pins), AD5593R_OK);
+  AD5593R_Control control(device);
+  CHECK_EQUAL(control.add_loop(2, 0, 0.5), AD5593R_ERROR_ROLE);
+  int loop = control.add_loop(0, 2, 0.5, 0.5);
+  CHECK_EQUAL(loop, 0);
+
+  // the output settles at twice the setpoint
+  control.set_setpoint(loop, 1000);
+  for (int i = 0; i < 60; i++) {
+    CHECK_EQUAL(step(control, chip), AD5593R_OK);
+  }
+  CHECK(abs(int(control.input(loop)) - 1000) <= 1);
+  CHECK(abs(int(control.output(loop)) - 2000) <= 2);
+  CHECK_EQUAL(chip.dac_output(2), control.output(loop));
+
+  // a setpoint out of reach holds the output at its limit, the integral stays inside the limits
+  control.set_output_limits(loop, 100, 3000);
+  control.set_setpoint(loop, 2000);
+  for (int i = 0; i < 200; i++) {
+    step(control, chip);
+    CHECK(control.integral(loop) >= 100 && control.integral(loop) <= 3000);
+  }
+  CHECK_EQUAL(control.output(loop), 3000);
+  CHECK_EQUAL(control.integral(loop), 3000);
+  control.set_setpoint(loop, 0);
+  for (int i = 0; i < 200; i++) {
+    step(control, chip);
+    CHECK(control.integral(loop) >= 100 && control.integral(loop) <= 3000);
+  }
+  CHECK_EQUAL(control.output(loop), 100);
+  CHECK_EQUAL(control.integral(loop), 100);
+
+  // without wind-up the output leaves the limit on the first tick and settles on a reachable setpoint
+  control.set_setpoint(loop, 700);
+  step(control, chip);
+  CHECK(control.output(loop) > 100);
+  for (int i = 0; i < 60; i++) {
+    step(control, chip);
+  }
+  CHECK(abs(int(control.input(loop)) - 700) <= 1);
+  CHECK(abs(int(control.output(loop)) - 1400) <= 2);
+  return check_result();
+}
@@ -0,0 +1,83 @@
+/*
+Checks the integer kernels of AD5593R_Filter against batches of known codes from the simulated chip:
+the decimation block average across batches, the moving average while its window fills and once it
+is full, and the IIR recurrence, each published to values.ADC_codes and values.ADCs.
+*/
+#include "check.h"
+#include "AD5593R.h"
+#include "AD5593R_Filter.h"
+#include "AD5593R_Sim.h"
+
+// sets the input of a channel to the voltage that converts to code with the 2.5 V reference
+static void set_code(AD5593R_Sim& chip, byte channel, uint16_t code) {
+  chip.set_input_voltage(channel, code * 2.5f / 4096);
+}
+
+// checks the result of a channel, a code with 4 fractional bits, and its published values
+static void check_output(AD5593R& device, AD5593R_Filter& filter, byte channel, uint16_t output) {
+  CHECK_EQUAL(filter.get(channel), output);
+  CHECK_EQUAL(device.values.ADC_codes[channel], (output + 8) >> 4);
+  CHECK_NEAR(device.values.ADCs[channel], output * 2.5 / 4095 / 16, 1e-5);
+}
+
+int main() {
+  AD5593R_Sim_Bus bus;
+  AD5593R_Sim chip;
+  bus.attach(chip);
+  AD5593R device(bus);
+  device.enable_internal_Vref();
+  AD5593R::configuration pins = {{1, 1, 0, 1, 0, 0, 0, 0}, {0, 0, 1, 0, 0, 0, 0, 0}, {0}, {0}};
+  CHECK_EQUAL(device.configure_pins(&pins), AD5593R_OK);
+  AD5593R_Filter filter(device);
+
+  CHECK_EQUAL(filter.update(), AD5593R_ERROR_ROLE);
+  CHECK_EQUAL(filter.set_decimation(2, 1), AD5593R_ERROR_ROLE);
+  CHECK_EQUAL(filter.set_decimation(0, 5), AD5593R_ERROR_RANGE);
+  CHECK_EQUAL(filter.set_moving_average(1, AD5593R_FILTER_MAX_LENGTH + 1), AD5593R_ERROR_RANGE);
+  CHECK_EQUAL(filter.set_IIR(3, 0), AD5593R_ERROR_RANGE);
+
+  // decimation by 4 samples, the block spans two batches: (2 * 100 + 2 * 103) / 4 = 101.5
+  CHECK_EQUAL(filter.set_decimation(0, 1), AD5593R_OK);
+  set_code(chip, 0, 100);
+  CHECK_EQUAL(filter.update(2), 0);
+  set_code(chip, 0, 103);
+  CHECK_EQUAL(filter.update(2), 0x01);
+  check_output(device, filter, 0, 1624);
+  // a batch of 8 holds two blocks, the result is the last one
+  set_code(chip, 0, 4000);
+  CHECK_EQUAL(filter.update(8), 0x01);
+  check_output(device, filter, 0, 64000);
+  filter.disable(0);
+
+  // moving average over 3 samples: 10, (10 + 20) / 2, (10 + 20 + 40) / 3, then (40 + 70 + 70) / 3
+  CHECK_EQUAL(filter.set_moving_average(1, 3), AD5593R_OK);
+  const uint16_t average_codes[] = {10, 20, 40};
+  const uint16_t average_outputs[] = {160, 240, 373};
+  for (int i = 0; i < 3; i++) {
+    set_code(chip, 1, average_codes[i]);
+    CHECK_EQUAL(filter.update(), 0x02);
+    check_output(device, filter, 1, average_outputs[i]);
+  }
+  set_code(chip, 1, 70);
+  CHECK_EQUAL(filter.update(2), 0x02);
+  check_output(device, filter, 1, 960);
+  filter.disable(1);
+
+  // IIR with a factor of 1/4, starting from the first sample: 1000, 1250, 1437.5, 1578.125
+  CHECK_EQUAL(filter.set_IIR(3, 2), AD5593R_OK);
+  set_code(chip, 3, 1000);
+  CHECK_EQUAL(filter.update(), 0x08);
+  check_output(device, filter, 3, 16000);
+  set_code(chip, 3, 2000);
+  CHECK_EQUAL(filter.update(), 0x08);
+  check_output(device, filter, 3, 20000);
+  CHECK_EQUAL(filter.update(2), 0x08);
+  check_output(device, filter, 3, 25250);
+
+  // reset() starts the IIR again from the next sample
+  filter.reset();
+  set_code(chip, 3, 500);
+  CHECK_EQUAL(filter.update(), 0x08);
+  check_output(device, filter, 3, 8000);
+  return check_result();
+}
@@ -0,0 +1,70 @@
+/*
+Checks AD5593R_Fixed against the simulated chip: the map is written by begin(), the calls reach the
+right pins and failed transactions are reported instead of read as data.
+*/
+#include "check.h"
+#include "AD5593R_Fixed.h"
+#include "AD5593R_Sim.h"
+
+typedef AD5593R_Channel_Map<0b00000011, 0b00001100, 0b00010000, 0b01100000, AD5593R_MAP_INTERNAL_VREF> Map;
+
+int main() {
+  AD5593R_Sim_Bus bus;
+  AD5593R_Sim chip;
+  bus.attach(chip);
+  AD5593R_Fixed<Map> device(bus);
+
+  bus.reset_stats();
+  CHECK_EQUAL(device.begin(), AD5593R_OK);
+  CHECK_EQUAL(bus.get_stats().transactions, 1);
+  CHECK_EQUAL(chip.reg(_ADAC_ADC_CONFIG), 0x03);
+  CHECK_EQUAL(chip.reg(_ADAC_DAC_CONFIG), 0x0c);
+  CHECK_EQUAL(chip.reg(_ADAC_GPIO_RD_CONFIG), 0x10);
+  CHECK_EQUAL(chip.reg(_ADAC_GPIO_WR_CONFIG), 0x60);
+  CHECK_EQUAL(chip.reg(_ADAC_PULL_DOWN), 0x80);
+  CHECK_EQUAL(chip.reg(_ADAC_POWER_REF_CTRL), _ADAC_VREF_ON << 8);
+
+  CHECK_EQUAL(device.write_DAC_code<2>(1000), AD5593R_OK);
+  CHECK_EQUAL(chip.dac_output(2), 1000);
+  CHECK_EQUAL(device.write_DAC_code<2>(5000), AD5593R_ERROR_RANGE);
+  uint16_t codes[8] = {0, 0, 1234, 4000};
+  CHECK_EQUAL(device.write_DAC_codes(codes), AD5593R_OK);
+  CHECK_EQUAL(chip.dac_output(2), 1234);
+  CHECK_EQUAL(chip.dac_output(3), 4000);
+
+  chip.set_input_voltage(0, 1.0);
+  chip.set_input_voltage(1, 2.0);
+  CHECK_NEAR(device.read_ADC_code<1>(), 3276, 2);
+  CHECK_EQUAL(device.read_ADC_codes(codes), 0x03);
+  CHECK_NEAR(codes[0], 1638, 2);
+
+  // GPIO readback, the pointer is only sent once
+  chip.set_input_level(4, HIGH);
+  byte levels = 0;
+  bus.reset_stats();
+  CHECK_EQUAL(device.read_GPIs(levels), AD5593R_OK);
+  CHECK_EQUAL(levels, 0x10);
+  CHECK_EQUAL(device.read_GPIs(levels), AD5593R_OK);
+  CHECK_EQUAL(bus.get_stats().transactions, 3);
+
+  CHECK_EQUAL(device.write_GPO<5>(1), AD5593R_OK);
+  CHECK_EQUAL(device.write_GPOs(0xff), AD5593R_OK);
+  CHECK_EQUAL(device.GPO_levels(), 0x60);
+  CHECK_NEAR(chip.pin_voltage(6), 3.3, 0.01);
+
+  // errors within the retry budget are retried, beyond it they are reported and change nothing
+  bus.reset_stats();
+  bus.inject_errors(AD5593R_RETRIES);
+  CHECK_EQUAL(device.write_DAC_code<3>(100), AD5593R_OK);
+  CHECK_EQUAL(bus.get_stats().transactions, AD5593R_RETRIES + 1);
+  chip.set_input_level(4, LOW);
+  bus.inject_errors(AD5593R_RETRIES + 1);
+  CHECK_EQUAL(device.read_GPIs(levels), AD5593R_ERROR_NACK);
+  CHECK_EQUAL(levels, 0x10);
+  bus.inject_errors(AD5593R_RETRIES + 1);
+  CHECK_EQUAL(device.write_GPOs(0x00), AD5593R_ERROR_NACK);
+  CHECK_EQUAL(device.GPO_levels(), 0x60);
+  bus.inject_errors(AD5593R_RETRIES + 1);
+  CHECK(device.read_ADC_code<0>() < 0);
+  return check_result();
+}
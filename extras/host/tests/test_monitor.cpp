@@ -0,0 +1,102 @@
+/*
+Checks the edge logic of AD5593R_Monitor: a simulated input swept up and down across both thresholds
+of a window fires ABOVE, INSIDE, BELOW and INSIDE exactly once each, only after the hysteresis, and a
+signal hovering at a threshold fires nothing more. GPI edges fire once per level change.
+*/
+#include "check.h"
+#include "AD5593R.h"
+#include "AD5593R_Monitor.h"
+#include "AD5593R_Sim.h"
+
+// sets the input of a channel to the voltage that converts to code with the 2.5 V reference
+static void set_code(AD5593R_Sim& chip, byte channel, uint16_t code) {
+  chip.set_input_voltage(channel, code * 2.5f / 4096);
+}
+
+// reads channel 0 at every code from start to end in steps of step
+static void sweep(AD5593R& device, AD5593R_Sim& chip, int start, int end, int step) {
+  for (int code = start; step > 0 ? code <= end : code >= end; code += step) {
+    set_code(chip, 0, code);
+    device.read_ADC_code(0);
+  }
+}
+
+int main() {
+  AD5593R_Sim_Bus bus;
+  AD5593R_Sim chip;
+  bus.attach(chip);
+  AD5593R device(bus);
+  device.enable_internal_Vref();
+  AD5593R::configuration pins = {{1, 0, 0, 0, 0, 0, 0, 0}, {0}, {0, 0, 0, 0, 1, 0, 0, 0}, {0}};
+  CHECK_EQUAL(device.configure_pins(&pins), AD5593R_OK);
+  AD5593R_Monitor monitor(device);
+  CHECK_EQUAL(monitor.set_window(0, 3000, 1000), AD5593R_ERROR_RANGE);
+  CHECK_EQUAL(monitor.set_window(0, 1000, 3000, 100), AD5593R_OK);
+  AD5593R_Monitor_Event event;
+
+  // up across the high threshold, and hovering around it
+  sweep(device, chip, 2000, 3500, 10);
+  sweep(device, chip, 3050, 2950, -10);
+  sweep(device, chip, 2950, 3050, 10);
+  CHECK(monitor.read(event));
+  CHECK_EQUAL(event.type, AD5593R_MONITOR_ABOVE);
+  CHECK_EQUAL(event.channel, 0);
+  CHECK_EQUAL(event.code, 3010);
+  CHECK(!monitor.read(event));
+  CHECK_EQUAL(monitor.state(0), AD5593R_MONITOR_ABOVE);
+
+  // down through the window and across the low threshold
+  sweep(device, chip, 3050, 500, -10);
+  const byte down[] = {AD5593R_MONITOR_INSIDE, AD5593R_MONITOR_BELOW};
+  const uint16_t down_codes[] = {2900, 990};
+  for (int i = 0; i < 2; i++) {
+    CHECK(monitor.read(event));
+    CHECK_EQUAL(event.type, down[i]);
+    CHECK_EQUAL(event.code, down_codes[i]);
+  }
+  CHECK(!monitor.read(event));
+
+  // hovering at the low threshold stays BELOW until the hysteresis is cleared
+  sweep(device, chip, 990, 1090, 10);
+  sweep(device, chip, 1090, 990, -10);
+  CHECK(!monitor.read(event));
+  sweep(device, chip, 990, 2000, 10);
+  CHECK(monitor.read(event));
+  CHECK_EQUAL(event.type, AD5593R_MONITOR_INSIDE);
+  CHECK_EQUAL(event.code, 1100);
+  CHECK(!monitor.read(event));
+  CHECK_EQUAL(monitor.state(0), AD5593R_MONITOR_INSIDE);
+
+  // GPI edges, the first read only sets the level
+  monitor.set_edges(4, 1, 1);
+  byte levels;
+  chip.set_input_level(4, LOW);
+  device.read_mask(levels);
+  CHECK(!monitor.read(event));
+  chip.set_input_level(4, HIGH);
+  device.read_mask(levels);
+  device.read_mask(levels);
+  CHECK(monitor.read(event));
+  CHECK_EQUAL(event.type, AD5593R_MONITOR_RISING);
+  CHECK_EQUAL(event.channel, 4);
+  CHECK(!monitor.read(event));
+  chip.set_input_level(4, LOW);
+  device.read_GPIs();
+  device.read_GPIs();
+  CHECK(monitor.read(event));
+  CHECK_EQUAL(event.type, AD5593R_MONITOR_FALLING);
+  CHECK(!monitor.read(event));
+
+  // only falling edges once rising ones are turned off
+  monitor.set_edges(4, 0, 1);
+  device.read_mask(levels);
+  chip.set_input_level(4, HIGH);
+  device.read_mask(levels);
+  chip.set_input_level(4, LOW);
+  device.read_mask(levels);
+  CHECK(monitor.read(event));
+  CHECK_EQUAL(event.type, AD5593R_MONITOR_FALLING);
+  CHECK(!monitor.read(event));
+  CHECK_EQUAL(monitor.dropped(), 0);
+  return check_result();
+}
@@ -0,0 +1,92 @@
+/*
+Checks the pointer bytes of the driver against the simulated chip, which decodes them from the data
+sheet: control register writes, ADC and GPIO readback and the GPIO outputs. A failed register write
+must not reach the chip with the next one.
+*/
+#include "check.h"
+#include "AD5593R.h"
+#include "AD5593R_Registers.h"
+#include "AD5593R_Sim.h"
+
+int main() {
+  AD5593R_Sim_Bus bus;
+  AD5593R_Sim chip;
+  bus.attach(chip);
+  AD5593R device(bus);
+  device.enable_internal_Vref();
+  AD5593R::configuration pins = {{1, 1, 0, 0, 0, 0, 0, 0},
+                                 {0, 0, 1, 1, 0, 0, 0, 0},
+                                 {0, 0, 0, 0, 1, 1, 0, 0},
+                                 {0, 0, 0, 0, 0, 0, 1, 1}};
+  CHECK_EQUAL(device.configure_pins(&pins), AD5593R_OK);
+
+  // the chip holds what the driver shadows
+  const byte addresses[] = {_ADAC_GP_CONTROL, _ADAC_ADC_CONFIG, _ADAC_DAC_CONFIG, _ADAC_GPIO_WR_CONFIG,
+                            _ADAC_GPIO_RD_CONFIG, _ADAC_POWER_REF_CTRL, _ADAC_PULL_DOWN};
+  for (byte address : addresses) {
+    CHECK_EQUAL(chip.reg(address), device.get_register(address));
+  }
+  CHECK_EQUAL(chip.reg(_ADAC_GPIO_RD_CONFIG), 0x30);
+  CHECK_EQUAL(chip.reg(_ADAC_GPIO_WR_CONFIG), 0xc0);
+
+  // GPIO readback, the pointer is written once and then only the read is repeated
+  chip.set_input_level(4, HIGH);
+  chip.set_input_level(5, LOW);
+  byte levels = 0;
+  bus.reset_stats();
+  CHECK_EQUAL(device.read_mask(levels), AD5593R_OK);
+  CHECK_EQUAL(levels, 0x10);
+  CHECK_EQUAL(bus.get_stats().transactions, 2);
+  chip.set_input_level(5, HIGH);
+  bus.reset_stats();
+  CHECK_EQUAL(device.read_mask(levels), AD5593R_OK);
+  CHECK_EQUAL(levels, 0x30);
+  CHECK_EQUAL(bus.get_stats().transactions, 1);
+  bool* GPIs = device.read_GPIs();
+  CHECK(GPIs[4] && GPIs[5]);
+
+  // a failed read reports its error and leaves the levels and values.GPI_reads as they were
+  chip.set_input_level(4, LOW);
+  bus.inject_errors(AD5593R_RETRIES + 1);
+  CHECK_EQUAL(device.read_mask(levels), AD5593R_ERROR_SHORT_READ);
+  CHECK_EQUAL(levels, 0x30);
+  bus.inject_errors(AD5593R_RETRIES + 1);
+  GPIs = device.read_GPIs();
+  CHECK(GPIs[4] && GPIs[5]);
+  CHECK_EQUAL(device.read_mask(levels), AD5593R_OK);
+  CHECK_EQUAL(levels, 0x20);
+
+  // GPIO outputs
+  device.write_mask(0x80);
+  CHECK_EQUAL(chip.reg(_ADAC_GPIO_WR_DATA), 0x80);
+  CHECK_NEAR(chip.pin_voltage(7), 3.3, 0.01);
+  CHECK_NEAR(chip.pin_voltage(6), 0, 0.01);
+
+  // DAC writes and ADC readback
+  CHECK_EQUAL(device.write_DAC_code(2, 1000), AD5593R_OK);
+  CHECK_EQUAL(chip.dac_output(2), 1000);
+  chip.set_input_voltage(0, 1.0);
+  CHECK_NEAR(device.read_ADC_code(0), 1638, 2);
+
+  // a failed write leaves the confirmed value in the shadow, the next setter does not send it
+  AD5593R_Sim_Bus other_bus;
+  AD5593R_Sim other_chip;
+  other_bus.attach(other_chip);
+  AD5593R other(other_bus);
+  CHECK_EQUAL(other.enable_internal_Vref(), AD5593R_OK);
+  other_bus.inject_errors(AD5593R_RETRIES + 1);
+  CHECK_EQUAL(other.set_ADC_max_2x_Vref(), AD5593R_ERROR_NACK);
+  CHECK_EQUAL(other.set_DAC_max_2x_Vref(), AD5593R_OK);
+  CHECK_EQUAL(other_chip.reg(_ADAC_GP_CONTROL), _ADAC_DAC_RANGE_2X);
+  CHECK_EQUAL(other.get_register(_ADAC_GP_CONTROL), _ADAC_DAC_RANGE_2X);
+  other_bus.inject_errors(AD5593R_RETRIES + 1);
+  CHECK_EQUAL(other.configure_DAC(1), AD5593R_ERROR_NACK);
+  CHECK_EQUAL(other.configure_DAC(2), AD5593R_OK);
+  CHECK_EQUAL(other_chip.reg(_ADAC_DAC_CONFIG), 0x04);
+  CHECK(!other.config.DACs[1] && other.config.DACs[2]);
+  AD5593R_State state;
+  other.save_state(&state);
+  CHECK_EQUAL(state.registers[_ADAC_DAC_CONFIG], 0x04);
+  CHECK_EQUAL(state.registers[_ADAC_GP_CONTROL], _ADAC_DAC_RANGE_2X);
+  return check_result();
+}
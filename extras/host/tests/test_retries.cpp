@@ -0,0 +1,120 @@
+/*
+Checks the retries, the health counters and the offline handling of AD5593R_Status.h with errors
+injected by the simulated bus.
+*/
+#include "check.h"
+#include "AD5593R.h"
+#include "AD5593R_Registers.h"
+#include "AD5593R_Sim.h"
+
+int main() {
+  AD5593R_Sim_Bus bus;
+  AD5593R_Sim chip;
+  bus.attach(chip);
+  AD5593R device(bus);
+  device.enable_internal_Vref();
+  AD5593R::configuration pins = {{1, 0, 0, 0, 0, 0, 0, 0}, {0, 1, 0, 0, 0, 0, 0, 0}, {0}, {0}};
+  device.configure_pins(&pins);
+  device.set_retries(2, 10);
+
+  // errors within the retry budget are invisible to the caller
+  bus.reset_stats();
+  bus.inject_errors(2);
+  CHECK_EQUAL(device.write_DAC_code(1, 1000), AD5593R_OK);
+  CHECK_EQUAL(bus.get_stats().transactions, 3);
+  CHECK_EQUAL(chip.dac_output(1), 1000);
+  CHECK_EQUAL(device.health().retries, 2);
+  CHECK_EQUAL(device.health().errors, 0);
+  CHECK_EQUAL(device.health().failures, 0);
+
+  // a used up budget fails the transaction
+  bus.inject_errors(3);
+  CHECK_EQUAL(device.write_DAC_code(1, 2000), AD5593R_ERROR_NACK);
+  CHECK_EQUAL(chip.dac_output(1), 1000);
+  CHECK_EQUAL(device.health().errors, 1);
+  CHECK_EQUAL(device.health().failures, 1);
+  CHECK_EQUAL(device.health().last_error, AD5593R_ERROR_NACK);
+  CHECK(device.online());
+  // a device that does not answer leaves the bus idle, it is not recovered
+  CHECK_EQUAL(device.health().recoveries, 0);
+  CHECK_EQUAL(bus.get_stats().recoveries, 0);
+
+  // a failed read returns its error, never a code
+  bus.inject_errors(3);
+  CHECK(device.read_ADC_code(0) < 0);
+  CHECK_EQUAL(device.health().failures, 2);
+
+  // AD5593R_OFFLINE_AFTER failures in a row take the device offline, its calls no longer reach the bus
+  for (int i = device.health().failures; i < AD5593R_OFFLINE_AFTER; i++) {
+    bus.inject_errors(3);
+    CHECK(device.write_DAC_code(1, 3000) != AD5593R_OK);
+  }
+  CHECK(!device.online());
+  bus.reset_stats();
+  CHECK_EQUAL(device.write_DAC_code(1, 3000), AD5593R_ERROR_OFFLINE);
+  CHECK_EQUAL(bus.get_stats().transactions, 0);
+
+  // a probe that is answered brings it back
+  CHECK_EQUAL(device.probe(), AD5593R_OK);
+  CHECK(device.online());
+  CHECK_EQUAL(device.health().failures, 0);
+  CHECK_EQUAL(device.write_DAC_code(1, 3000), AD5593R_OK);
+  CHECK_EQUAL(chip.dac_output(1), 3000);
+
+  // a bus error or timeout recovers the bus, as does a NACK with SDA held low
+  bus.reset_stats();
+  bus.inject_errors(3, 5);
+  CHECK_EQUAL(device.write_DAC_code(1, 3000), AD5593R_ERROR_BUS);
+  CHECK_EQUAL(bus.get_stats().recoveries, 1);
+  CHECK_EQUAL(device.health().recoveries, 1);
+  bus.inject_errors(3);
+  bus.hold_sda();
+  CHECK_EQUAL(device.write_DAC_code(1, 3000), AD5593R_ERROR_NACK);
+  CHECK_EQUAL(bus.get_stats().recoveries, 2);
+  CHECK(!bus.stuck());
+  CHECK_EQUAL(device.write_DAC_code(1, 3001), AD5593R_OK);
+
+  // without retries the first error fails the call
+  device.set_retries(0);
+  bus.reset_stats();
+  bus.inject_errors(1);
+  CHECK_EQUAL(device.write_DAC_code(1, 100), AD5593R_ERROR_NACK);
+  CHECK_EQUAL(bus.get_stats().transactions, 1);
+
+  // a failed configuration call leaves the reference, ranges and roles of the driver as they were,
+  // and calling it again writes the register
+  AD5593R_Sim_Bus fresh_bus;
+  AD5593R_Sim fresh_chip;
+  fresh_bus.attach(fresh_chip);
+  AD5593R fresh(fresh_bus);
+  fresh.set_retries(0);
+  fresh_bus.inject_errors(1);
+  CHECK_EQUAL(fresh.enable_internal_Vref(), AD5593R_ERROR_NACK);
+  fresh_bus.inject_errors(1);
+  CHECK_EQUAL(fresh.configure_DAC(0), AD5593R_ERROR_NACK);
+  CHECK_EQUAL(fresh.write_DAC_code(0, 100), AD5593R_ERROR_ROLE);
+  CHECK_EQUAL(fresh.configure_DAC(0), AD5593R_OK);
+  CHECK_EQUAL(fresh.write_DAC(0, 1.0), AD5593R_ERROR_NO_VREF);
+  CHECK_EQUAL(fresh.enable_internal_Vref(), AD5593R_OK);
+  CHECK_EQUAL(fresh.write_DAC(0, 1.0), AD5593R_OK);
+  fresh_bus.inject_errors(1);
+  CHECK_EQUAL(fresh.set_DAC_max_2x_Vref(), AD5593R_ERROR_NACK);
+  CHECK_EQUAL(fresh.write_DAC(0, 4.0), AD5593R_ERROR_RANGE);
+  CHECK_EQUAL(fresh.set_DAC_max_2x_Vref(), AD5593R_OK);
+  CHECK_EQUAL(fresh.write_DAC(0, 4.0), AD5593R_OK);
+  CHECK(fresh_chip.reg(_ADAC_GP_CONTROL) & _ADAC_DAC_RANGE_2X);
+
+  CHECK_EQUAL(fresh.configure_GPO(3), AD5593R_OK);
+  bool levels[8] = {0, 0, 0, 1, 0, 0, 0, 0};
+  fresh_bus.inject_errors(1);
+  CHECK_EQUAL(fresh.write_GPOs(levels), AD5593R_ERROR_NACK);
+  CHECK(!fresh.values.GPO_writes[3]);
+  CHECK_EQUAL(fresh.write_GPOs(levels), AD5593R_OK);
+  CHECK(fresh.values.GPO_writes[3]);
+  CHECK_EQUAL(fresh_chip.reg(_ADAC_GPIO_WR_DATA), 0x08);
+  fresh_bus.inject_errors(1);
+  CHECK_EQUAL(fresh.clear_mask(0x08), AD5593R_ERROR_NACK);
+  CHECK_EQUAL(fresh.clear_mask(0x08), AD5593R_OK);
+  CHECK_EQUAL(fresh_chip.reg(_ADAC_GPIO_WR_DATA), 0x00);
+  return check_result();
+}
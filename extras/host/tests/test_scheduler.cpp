@@ -0,0 +1,75 @@
+/*
+Checks the deadlines of AD5593R_Scheduler in real time: every channel is sampled at its period, the
+samples carry the time of their scan and slow channels share the scans of the fast ones.
+The bounds leave room for a loaded build machine.
+*/
+#include "check.h"
+#include "AD5593R.h"
+#include "AD5593R_Scheduler.h"
+#include "AD5593R_Sim.h"
+
+int main() {
+  AD5593R_Sim_Bus bus;
+  AD5593R_Sim chip;
+  bus.attach(chip);
+  AD5593R device(bus);
+  device.enable_internal_Vref();
+  AD5593R::configuration pins = {{1, 0, 0, 0, 1, 1, 1, 1}, {0}, {0}, {0}};
+  device.configure_pins(&pins);
+  chip.set_input_voltage(0, 1.0);
+  chip.set_input_voltage(5, 2.0);
+
+  AD5593R_Scheduler scheduler(device);
+  CHECK_EQUAL(scheduler.set_period(1, 100), AD5593R_ERROR_ROLE);
+  CHECK_EQUAL(scheduler.set_period(0, 0), AD5593R_ERROR_RANGE);
+  CHECK_EQUAL(scheduler.set_period(0, 1000), AD5593R_OK);
+  for (byte channel = 4; channel < 8; channel++) {
+    CHECK_EQUAL(scheduler.set_period(channel, 10000), AD5593R_OK);
+  }
+  scheduler.restart();
+
+  unsigned long counts[8] = {0};
+  uint32_t last[8] = {0};
+  bool codes_ok = true;
+  bool times_ok = true;
+  unsigned long start = micros();
+  unsigned long now = start;
+  while (now - start < 200000) {
+    now = micros();
+    scheduler.poll();
+    AD5593R_Timed_Sample sample;
+    while (scheduler.read(sample)) {
+      if (sample.channel == 0) {
+        if (sample.code < 1630 || sample.code > 1646) codes_ok = false;
+      }
+      if (sample.channel == 5 && (sample.code < 3270 || sample.code > 3284)) codes_ok = false;
+      if (counts[sample.channel] && sample.time <= last[sample.channel]) times_ok = false;
+      counts[sample.channel]++;
+      last[sample.channel] = sample.time;
+    }
+  }
+  AD5593R_Scheduler_Stats stats;
+  scheduler.get_stats(&stats);
+
+  // 200 ms at 1 ms and 10 ms
+  CHECK(counts[0] >= 150 && counts[0] <= 201);
+  CHECK(counts[5] >= 15 && counts[5] <= 21);
+  CHECK_EQUAL(counts[1], 0);
+  CHECK_EQUAL(counts[4], counts[7]);
+  CHECK(codes_ok);
+  CHECK(times_ok);
+  // deadlines stay on the grid: each one that passed was either sampled or counted as missed
+  CHECK_NEAR(counts[0] + stats.missed[0], (now - start) / 1000.0, 2);
+  // the slow channels never need a scan of their own
+  CHECK_EQUAL(stats.scans, counts[0]);
+  CHECK_EQUAL(stats.errors, 0);
+  CHECK_EQUAL(stats.dropped, 0);
+
+  // a stall skips the deadlines it covered instead of catching up with a burst
+  unsigned long missed = stats.missed[0];
+  delay(5);
+  scheduler.poll();
+  scheduler.get_stats(&stats);
+  CHECK(stats.missed[0] >= missed + 3);
+  return check_result();
+}
@@ -0,0 +1,75 @@
+/*
+Checks the snapshots of AD5593R_Seqlock.h under contention: a thread keeps writing all eight DAC
+codes with one value while the main thread takes snapshots, none of them may mix two writes.
+Calls that fail must leave values_version() as it was.
+*/
+#include <atomic>
+#include <thread>
+#include "check.h"
+#include "AD5593R.h"
+#include "AD5593R_Sim.h"
+
+int main() {
+  AD5593R_Sim_Bus bus;
+  AD5593R_Sim chip;
+  bus.attach(chip);
+  AD5593R device(bus);
+  device.enable_internal_Vref();
+  AD5593R::configuration pins = {{0}, {1, 1, 1, 1, 1, 1, 1, 1}, {0}, {0}};
+  device.configure_pins(&pins);
+
+  // the constructor publishes the starting values
+  uint32_t first = device.values_version();
+  CHECK(first > 0);
+  uint16_t codes[8] = {7, 7, 7, 7, 7, 7, 7, 7};
+  CHECK_EQUAL(device.write_DAC_codes(codes), AD5593R_OK);
+  AD5593R::Read_write_values copy = AD5593R::Read_write_values();
+  CHECK(device.snapshot(&copy) > first);
+  CHECK_EQUAL(copy.DAC_codes[3], 7);
+
+  // calls that fail change no value and publish nothing
+  uint32_t written = device.values_version();
+  CHECK_EQUAL(device.read_ADC_code(0), AD5593R_ERROR_ROLE);
+  CHECK_EQUAL(device.write_DAC_code(0, 5000), AD5593R_ERROR_RANGE);
+  bus.inject_errors(100);
+  CHECK(device.write_DAC_code(0, 9) < 0);
+  CHECK(device.write_DAC_codes(codes) < 0);
+  device.read_GPIs();
+  bus.inject_errors(0);
+  CHECK_EQUAL(device.values_version(), written);
+  // the failures took the device offline
+  CHECK_EQUAL(device.probe(), AD5593R_OK);
+  CHECK_EQUAL(device.write_DAC_codes(codes), AD5593R_OK);
+  CHECK(device.values_version() > written);
+
+  std::atomic<bool> stop(false);
+  std::thread writer([&] {
+    for (uint16_t k = 0; !stop; k = (k + 1) & 4095) {
+      uint16_t same[8];
+      for (int i = 0; i < 8; i++) same[i] = k;
+      device.write_DAC_codes(same);
+    }
+  });
+  unsigned long good = 0;
+  unsigned long torn = 0;
+  bool monotonic = true;
+  uint32_t last = 0;
+  for (int n = 0; n < 200000; n++) {
+    uint32_t version = device.snapshot(&copy);
+    if (!version) continue;
+    if (version < last) monotonic = false;
+    last = version;
+    bool same = true;
+    for (int i = 1; i < 8; i++) {
+      if (copy.DAC_codes[i] != copy.DAC_codes[0]) same = false;
+    }
+    same ? good++ : torn++;
+  }
+  stop = true;
+  writer.join();
+
+  CHECK_EQUAL(torn, 0);
+  CHECK(good > 0);
+  CHECK(monotonic);
+  return check_result();
+}
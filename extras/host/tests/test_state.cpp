@@ -0,0 +1,61 @@
+/*
+Checks a warm start: the state saved from a configured device is serialized, the chip and the driver
+are reset, and restore_state() with verify brings the registers and DAC outputs back and reads them
+back through REG_READ and DAC_READ. A register the chip does not keep fails the verify.
+*/
+#include "check.h"
+#include "AD5593R.h"
+#include "AD5593R_Registers.h"
+#include "AD5593R_Sim.h"
+
+int main() {
+  AD5593R_Sim_Bus bus;
+  AD5593R_Sim chip;
+  bus.attach(chip);
+  AD5593R device(bus);
+  device.enable_internal_Vref();
+  device.set_DAC_max_2x_Vref();
+  AD5593R::configuration pins = {{1, 1, 0, 0, 0, 0, 0, 0},
+                                 {0, 0, 1, 1, 1, 0, 0, 0},
+                                 {0, 0, 0, 0, 0, 1, 0, 0},
+                                 {0, 0, 0, 0, 0, 0, 1, 1}};
+  CHECK_EQUAL(device.configure_pins(&pins), AD5593R_OK);
+  CHECK_EQUAL(device.write_DAC_code(2, 1000), AD5593R_OK);
+  CHECK_EQUAL(device.write_DAC_code(3, 2000), AD5593R_OK);
+  CHECK_EQUAL(device.write_DAC_code(4, 3000), AD5593R_OK);
+  CHECK_EQUAL(device.set_mask(0x80), AD5593R_OK);
+  uint16_t before[16];
+  for (int i = 0; i < 16; i++) before[i] = chip.reg(i);
+
+  AD5593R_State saved;
+  device.save_state(&saved);
+  byte buffer[AD5593R_STATE_SIZE];
+  CHECK_EQUAL(saved.serialize(buffer), AD5593R_STATE_SIZE);
+  AD5593R_State state;
+  CHECK(state.deserialize(buffer, AD5593R_STATE_SIZE));
+
+  // a brownout resets the chip and the microcontroller
+  chip.reset();
+  AD5593R restarted(bus);
+  CHECK_EQUAL(restarted.restore_state(state, true), AD5593R_OK);
+  const byte addresses[] = {_ADAC_GP_CONTROL, _ADAC_ADC_CONFIG, _ADAC_DAC_CONFIG, _ADAC_GPIO_WR_CONFIG,
+                            _ADAC_GPIO_WR_DATA, _ADAC_GPIO_RD_CONFIG, _ADAC_POWER_REF_CTRL, _ADAC_PULL_DOWN};
+  for (byte address : addresses) {
+    CHECK_EQUAL(chip.reg(address), before[address]);
+    CHECK_EQUAL(restarted.get_register(address), before[address]);
+  }
+  CHECK_EQUAL(chip.dac_output(2), 1000);
+  CHECK_EQUAL(chip.dac_output(3), 2000);
+  CHECK_EQUAL(chip.dac_output(4), 3000);
+  CHECK_EQUAL(restarted.values.DAC_codes[3], 2000);
+  CHECK_NEAR(chip.pin_voltage(7), 3.3, 0.01);
+  CHECK_EQUAL(restarted.write_DAC_code(4, 100), AD5593R_OK);
+  CHECK_EQUAL(chip.dac_output(4), 100);
+
+  // the chip keeps only 12 bits of a DAC code, the readback of a corrupted state does not match
+  AD5593R_State corrupted = state;
+  corrupted.DAC_codes[2] = 0x1000 | 1000;
+  CHECK_EQUAL(restarted.restore_state(corrupted, true), AD5593R_ERROR_VERIFY);
+  CHECK_EQUAL(restarted.restore_state(state, true), AD5593R_OK);
+  return check_result();
+}
@@ -0,0 +1,70 @@
+/*
+Checks the streaming mode against the simulated sequencer: start_ADC_stream() writes the sequence
+with the repeat bit once, poll_ADC_stream() only reads and tags each sample with its channel, stops
+at the free space of the buffer, and arms the stream again after another ADC call changed the sequence.
+*/
+#include "check.h"
+#include "AD5593R.h"
+#include "AD5593R_Registers.h"
+#include "AD5593R_Sim.h"
+
+int main() {
+  AD5593R_Sim_Bus bus;
+  AD5593R_Sim chip;
+  bus.attach(chip);
+  AD5593R device(bus);
+  device.enable_internal_Vref();
+  AD5593R::configuration pins = {{1, 1, 0, 1, 0, 0, 0, 0}, {0}, {0}, {0}};
+  CHECK_EQUAL(device.configure_pins(&pins), AD5593R_OK);
+  chip.set_input_voltage(0, 1.0);
+  chip.set_input_voltage(1, 2.0);
+  chip.set_input_voltage(3, 0.5);
+  const byte channels[3] = {0, 1, 3};
+  const uint16_t codes[3] = {1638, 3277, 819};
+
+  // the sequence and the read pointer go out once, polling only reads
+  static AD5593R_Sample_Buffer buffer;
+  bus.reset_stats();
+  CHECK_EQUAL(device.start_ADC_stream(buffer), AD5593R_OK);
+  CHECK_EQUAL(chip.reg(_ADAC_ADC_SEQUENCE), (_ADAC_SEQUENCE_ON << 8) | 0x0b);
+  unsigned long writes = bus.get_stats().writes;
+  CHECK_EQUAL(device.poll_ADC_stream(7), 7);
+  CHECK_EQUAL(device.poll_ADC_stream(5), 5);
+  CHECK_EQUAL(bus.get_stats().writes, writes);
+  CHECK_EQUAL(buffer.size(), 12);
+
+  // the sequencer wraps around, every sample carries its channel
+  uint16_t samples[12];
+  CHECK_EQUAL(buffer.read(samples, 12), 12);
+  for (int i = 0; i < 12; i++) {
+    CHECK_EQUAL(AD5593R_Sample_Buffer::channel(samples[i]), channels[i % 3]);
+    CHECK_EQUAL(AD5593R_Sample_Buffer::code(samples[i]), codes[i % 3]);
+  }
+
+  // polling stops at the free space of the buffer
+  CHECK_EQUAL(device.poll_ADC_stream(2), 2);
+  CHECK_EQUAL(device.poll_ADC_stream(), AD5593R_Sample_Buffer::capacity - 2);
+  CHECK_EQUAL(buffer.space(), 0);
+  bus.reset_stats();
+  CHECK_EQUAL(device.poll_ADC_stream(), 0);
+  CHECK_EQUAL(bus.get_stats().transactions, 0);
+
+  // a single conversion in between replaces the sequence, the next poll writes it again
+  buffer.clear();
+  CHECK_EQUAL(device.read_ADC_code(1), 3277);
+  CHECK(chip.reg(_ADAC_ADC_SEQUENCE) != ((_ADAC_SEQUENCE_ON << 8) | 0x0b));
+  CHECK_EQUAL(device.poll_ADC_stream(3), 3);
+  CHECK_EQUAL(chip.reg(_ADAC_ADC_SEQUENCE), (_ADAC_SEQUENCE_ON << 8) | 0x0b);
+  CHECK_EQUAL(buffer.read(samples, 3), 3);
+  for (int i = 0; i < 3; i++) {
+    CHECK_EQUAL(AD5593R_Sample_Buffer::channel(samples[i]), channels[i]);
+    CHECK_EQUAL(AD5593R_Sample_Buffer::code(samples[i]), codes[i]);
+  }
+
+  // once stopped nothing is read
+  device.stop_ADC_stream();
+  bus.reset_stats();
+  CHECK_EQUAL(device.poll_ADC_stream(), 0);
+  CHECK_EQUAL(bus.get_stats().transactions, 0);
+  return check_result();
+}
@@ -0,0 +1,62 @@
+/*
+Checks the temperature indicator against the simulated chip, in the 1x and 2x ADC range: read_ADCs()
+decodes channel 8 of the sequence into values.temperature_code and values.temperature with the data
+sheet equation, and an ADC stream carries it as channel 8 after the ADC channels.
+*/
+#include "check.h"
+#include "AD5593R.h"
+#include "AD5593R_Sim.h"
+
+// the data sheet equation, solved for the code
+static uint16_t expected_code(float celsius, bool range_2x) {
+  const float Vref = 2.5f;
+  if (range_2x) return uint16_t((0.5f / (2 * Vref)) * 4095 + (celsius - 25) * 1.327f + 0.5f);
+  return uint16_t((0.5f / Vref) * 4095 + (celsius - 25) * 2.654f + 0.5f);
+}
+
+int main() {
+  AD5593R_Sim_Bus bus;
+  AD5593R_Sim chip;
+  bus.attach(chip);
+  AD5593R device(bus);
+  device.enable_internal_Vref();
+  AD5593R::configuration pins = {{1, 0, 0, 0, 0, 0, 0, 0}, {0}, {0}, {0}};
+  CHECK_EQUAL(device.configure_pins(&pins), AD5593R_OK);
+  device.enable_temperature();
+  chip.set_input_voltage(0, 1.0);
+
+  const float temperatures[] = {-40, 25, 60, 105};
+  for (int range_2x = 0; range_2x < 2; range_2x++) {
+    CHECK_EQUAL(range_2x ? device.set_ADC_max_2x_Vref() : device.set_ADC_max_1x_Vref(), AD5593R_OK);
+    // one code is 1 / 2.654 degrees in the 1x range, twice that in the 2x range
+    float resolution = range_2x ? 0.76f : 0.38f;
+    for (float celsius : temperatures) {
+      chip.set_temperature(celsius);
+      float* ADCs = device.read_ADCs();
+      CHECK_EQUAL(device.values.temperature_code, expected_code(celsius, range_2x));
+      CHECK_NEAR(device.values.temperature, celsius, resolution);
+      CHECK_NEAR(device.temperature_code_to_mC(device.values.temperature_code), celsius * 1000, resolution * 1000);
+      // the ADC channel is decoded next to it
+      CHECK_NEAR(ADCs[0], 1.0, 0.002);
+    }
+
+    // in a stream the indicator follows the ADC channels as channel 8
+    chip.set_temperature(60);
+    static AD5593R_Sample_Buffer buffer;
+    buffer.clear();
+    CHECK_EQUAL(device.start_ADC_stream(buffer), AD5593R_OK);
+    CHECK_EQUAL(device.poll_ADC_stream(4), 4);
+    device.stop_ADC_stream();
+    uint16_t samples[4];
+    CHECK_EQUAL(buffer.read(samples, 4), 4);
+    for (int i = 0; i < 4; i++) {
+      bool temperature = i & 1;
+      CHECK_EQUAL(AD5593R_Sample_Buffer::channel(samples[i]), temperature ? 8 : 0);
+      if (!temperature) continue;
+      uint16_t code = AD5593R_Sample_Buffer::code(samples[i]);
+      CHECK_EQUAL(code, expected_code(60, range_2x));
+      CHECK_NEAR(device.temperature_code_to_mC(code), 60000, resolution * 1000);
+    }
+  }
+  return check_result();
+}
@@ -0,0 +1,59 @@
+/*
+Checks AD5593R_Waveform playback: the device is selected once per playback, failed writes are
+counted and playback stops once the device has gone offline. A rate above 1 MHz is rejected.
+*/
+#include "check.h"
+#include "AD5593R.h"
+#include "AD5593R_Waveform.h"
+#include "AD5593R_Sim.h"
+
+int main() {
+  AD5593R_Sim_Bus bus;
+  AD5593R_Sim chip(23);
+  bus.attach(chip);
+  AD5593R device(bus, 23);
+  AD5593R::configuration pins = {{0}, {1, 1, 0, 0, 0, 0, 0, 0}, {0}, {0}};
+  device.configure_pins(&pins);
+
+  static byte table[3 * 2 * 64];
+  AD5593R_Waveform waveform(device, table, sizeof(table));
+  CHECK(waveform.set_length(0x03, 64));
+  waveform.set_ramp(0, 0, 630);
+  waveform.set_sine(1, 2048, 1000);
+
+  bus.reset_stats();
+  waveform.play(20000, 1);
+  CHECK(!waveform.playing());
+  CHECK_EQUAL(bus.get_stats().writes, 64);
+  CHECK_EQUAL(bus.get_stats().a0_changes, 2);
+  CHECK_EQUAL(chip.dac_output(0), 630);
+  CHECK_EQUAL(waveform.errors(), 0);
+
+  // a failed sample is counted and playback goes on
+  device.set_retries(0);
+  bus.inject_errors(1);
+  waveform.play(20000, 1);
+  CHECK_EQUAL(waveform.errors(), 1);
+  CHECK(device.online());
+
+  // a rate above 1 MHz would give a period of 0 us, it is rejected
+  CHECK(!waveform.start(1000001));
+  CHECK(!waveform.playing());
+  CHECK(waveform.start(1000000));
+  CHECK(waveform.playing());
+  waveform.stop();
+
+  // once the device is offline playback stops
+  bus.reset_stats();
+  bus.inject_errors(1000);
+  waveform.start(20000);
+  unsigned long start = millis();
+  while (waveform.playing() && millis() - start < 100) {
+    waveform.update();
+  }
+  CHECK(!waveform.playing());
+  CHECK(!device.online());
+  CHECK_EQUAL(waveform.errors(), 1 + AD5593R_OFFLINE_AFTER);
+  CHECK_EQUAL(bus.get_stats().transactions, AD5593R_OFFLINE_AFTER);
+  return check_result();
+}